@@ -1,5 +1,10 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include "listFile.h"
 
 // Linked list node structure
 // Each node contains an integer data and a pointer to the next node.
@@ -8,128 +13,445 @@ struct Node {
     struct Node* next;    // Pointer to the next node
 };
 
+// Linked list handle
+// Keeps both ends of the list and its length, so appending and asking for the size are O(1).
+struct List {
+    struct Node* head;    // First node, NULL when the list is empty
+    struct Node* tail;    // Last node, NULL when the list is empty
+    int size;             // Number of nodes in the list
+};
+
+// Node allocation
+// Compile with -DUSE_NODE_POOL to take nodes from the slab allocator in nodePool.h
+// instead of calling malloc/free for every node.
+#ifdef USE_NODE_POOL
+#include "nodePool.h"
+static NodePool nodePool = NODE_POOL_INITIALIZER(sizeof(struct Node));
+#endif
+
 // Function to create a new node
 // Allocates memory for a new node, assigns the given value to data, and sets next to NULL.
 struct Node* yeniNode(int value) {
+#ifdef USE_NODE_POOL
+    struct Node* newNode = (struct Node*)poolAlloc(&nodePool);
+#else
     struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
+#endif
     newNode->data = value;
     newNode->next = NULL;
     return newNode;
 }
 
+// Function to release a node
+// Returns the node to the pool when USE_NODE_POOL is set, otherwise frees it.
+void freeNode(struct Node* node) {
+#ifdef USE_NODE_POOL
+    poolFree(&nodePool, node);
+#else
+    free(node);
+#endif
+}
+
+// Function to initialize a list
+// Sets up an empty list: no head, no tail and a size of zero.
+void initList(struct List* list) {
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+}
+
+// Function to get the number of nodes in the list
+// The size is kept up to date by every operation, so no traversal is needed.
+int listSize(struct List* list) {
+    return list->size;
+}
+
 // Function to insert a node at the beginning of the list
 // Updates the head pointer to the new node.
-void insertAtBeginning(struct Node** head, int value) {
+void insertAtBeginning(struct List* list, int value) {
     struct Node* newNode = yeniNode(value);
-    newNode->next = *head;
-    *head = newNode;
+    newNode->next = list->head;
+    list->head = newNode;
+    if (list->tail == NULL) {
+        list->tail = newNode; // The first node is also the last one
+    }
+    list->size++;
 }
 
 // Function to insert a node at the end of the list
-// Traverses the list to find the last node and appends the new node.
-void insertAtEnd(struct Node** head, int value) {
+// Links the new node after the tail, so no traversal is needed.
+void insertAtEnd(struct List* list, int value) {
     struct Node* newNode = yeniNode(value);
-    if (*head == NULL) {
-        *head = newNode;
-        return;
+    if (list->tail == NULL) {
+        list->head = newNode;
+    } else {
+        list->tail->next = newNode;
     }
-    struct Node* current = *head;
-    while (current->next != NULL) {
-        current = current->next;
-    }
-    current->next = newNode;
+    list->tail = newNode;
+    list->size++;
 }
 
 // Function to insert a node after a given index (0-based index)
 // Inserts a new node after the node at the specified index.
-void insertAfterIndex(struct Node** head, int value, int index) {
-    struct Node* newNode = yeniNode(value);
+void insertAfterIndex(struct List* list, int value, int index) {
+    if (index < 0 || index > list->size)
+        return; // Index out of bounds, do nothing
     if (index == 0) {
-        newNode->next = *head;
-        *head = newNode;
+        insertAtBeginning(list, value);
+        return;
+    }
+    if (index == list->size) {
+        insertAtEnd(list, value);
         return;
     }
-    struct Node* current = *head;
+    struct Node* newNode = yeniNode(value);
+    struct Node* current = list->head;
     for (int i = 0; i < index - 1; i++) {
-        if (current == NULL)
-            return; // Index out of bounds, do nothing
         current = current->next;
     }
     newNode->next = current->next;
     current->next = newNode;
+    list->size++;
 }
 
 // Function to delete the first node of the list
-void deleteFromBeginning(struct Node** head) {
-    if (*head == NULL) return;
-    struct Node* temp = *head;
-    *head = (*head)->next;
-    free(temp);
+void deleteFromBeginning(struct List* list) {
+    if (list->head == NULL) return;
+    struct Node* temp = list->head;
+    list->head = temp->next;
+    if (list->head == NULL) {
+        list->tail = NULL; // The list became empty
+    }
+    freeNode(temp);
+    list->size--;
 }
 
 // Function to delete the last node of the list
-void deleteFromEnd(struct Node** head) {
-    if (*head == NULL) return;
-    if ((*head)->next == NULL) {
-        free(*head);
-        *head = NULL;
+// A singly linked node does not know its predecessor, so the new tail is still found by a walk.
+void deleteFromEnd(struct List* list) {
+    if (list->head == NULL) return;
+    if (list->head == list->tail) {
+        deleteFromBeginning(list);
         return;
     }
-    struct Node* current = *head;
-    while (current->next->next != NULL) {
+    struct Node* current = list->head;
+    while (current->next != list->tail) {
         current = current->next;
     }
-    free(current->next);
+    freeNode(list->tail);
     current->next = NULL;
+    list->tail = current;
+    list->size--;
 }
 
 // Function to delete a node at a given index (0-based index)
-void deleteAtIndex(struct Node** head, int index) {
-    if (*head == NULL) return;
-    struct Node* current = *head;
+void deleteAtIndex(struct List* list, int index) {
+    if (index < 0 || index >= list->size) return; // Index out of bounds
     if (index == 0) {
-        *head = current->next;
-        free(current);
+        deleteFromBeginning(list);
         return;
     }
-    for (int i = 0; current != NULL && i < index - 1; i++) {
+    struct Node* current = list->head;
+    for (int i = 0; i < index - 1; i++) {
         current = current->next;
     }
-    if (current == NULL || current->next == NULL) return; // Index out of bounds
-    struct Node* nextNode = current->next->next;
-    free(current->next);
-    current->next = nextNode;
+    struct Node* target = current->next;
+    current->next = target->next;
+    if (target == list->tail) {
+        list->tail = current; // The last node was removed
+    }
+    freeNode(target);
+    list->size--;
 }
 
 // Function to reverse the linked list
 // Reverses the direction of the node links so that the last node becomes the head.
-void reverseList(struct Node** head) {
+void reverseList(struct List* list) {
     struct Node* prev = NULL;
-    struct Node* current = *head;
+    struct Node* current = list->head;
     struct Node* nextNode = NULL;
+    list->tail = current;          // The old head becomes the tail
     while (current != NULL) {
         nextNode = current->next;  // Save next node
         current->next = prev;      // Reverse the link
         prev = current;            // Move prev forward
         current = nextNode;        // Move current forward
     }
-    *head = prev; // Update head to the new first node
+    list->head = prev; // Update head to the new first node
 }
 
 // Function to make the list circular
 // Connects the last node's next pointer to the head, forming a circular list.
-void makeCircular(struct Node* head) {
-    if (head == NULL) return;
-    struct Node* current = head;
-    while (current->next != NULL) {
+// After this call the list must no longer be used with the NULL-terminated functions above.
+void makeCircular(struct List* list) {
+    if (list->head == NULL) return;
+    list->tail->next = list->head;
+}
+
+// Function to append the values of an array to the list
+// Creates the nodes in one pass and links each one straight after the previous one,
+// so there is no per-value call or tail lookup. With USE_NODE_POOL all nodes are taken
+// from the pool as one contiguous block, so the new chain lies in memory in list order.
+void buildFromArray(struct List* list, const int* values, int count) {
+    if (count <= 0) return;
+#ifdef USE_NODE_POOL
+    char* block = (char*)poolAllocBlock(&nodePool, count);
+#endif
+    struct Node dummy;
+    struct Node* last = &dummy;
+    for (int i = 0; i < count; i++) {
+#ifdef USE_NODE_POOL
+        struct Node* newNode = (struct Node*)(block + (size_t)i * nodePool.nodeSize);
+        newNode->data = values[i];
+#else
+        struct Node* newNode = yeniNode(values[i]);
+#endif
+        last->next = newNode;
+        last = newNode;
+    }
+    last->next = NULL;
+    if (list->tail == NULL) {
+        list->head = dummy.next;
+    } else {
+        list->tail->next = dummy.next;
+    }
+    list->tail = last;
+    list->size += count;
+}
+
+// Function to concatenate two lists in O(1)
+// Moves every node of src to the end of dest and leaves src empty.
+void spliceLists(struct List* dest, struct List* src) {
+    if (src->head == NULL) return;
+    if (dest->tail == NULL) {
+        dest->head = src->head;
+    } else {
+        dest->tail->next = src->head;
+    }
+    dest->tail = src->tail;
+    dest->size += src->size;
+    initList(src);
+}
+
+// Function to split the list at a given index (0-based index)
+// Nodes from index onward are moved into rest (which is overwritten); list keeps the first index nodes.
+void splitAtIndex(struct List* list, int index, struct List* rest) {
+    initList(rest);
+    if (index < 0 || index >= list->size) return; // Nothing to move
+    if (index == 0) {
+        *rest = *list;
+        initList(list);
+        return;
+    }
+    struct Node* current = list->head;
+    for (int i = 0; i < index - 1; i++) {
         current = current->next;
     }
-    current->next = head;
+    rest->head = current->next;
+    rest->tail = list->tail;
+    rest->size = list->size - index;
+    current->next = NULL;
+    list->tail = current;
+    list->size = index;
+}
+
+// Function to merge two sorted chains of nodes
+// Returns the head of the merged chain and stores its last node in *tail. Equal values keep
+// their order (a before b), which makes the merge sort stable.
+struct Node* mergeChains(struct Node* a, struct Node* b, struct Node** tail) {
+    struct Node dummy;
+    struct Node* last = &dummy;
+    while (a != NULL && b != NULL) {
+        if (b->data < a->data) {
+            last->next = b;
+            b = b->next;
+        } else {
+            last->next = a;
+            a = a->next;
+        }
+        last = last->next;
+    }
+    last->next = (a != NULL) ? a : b;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    *tail = last;
+    return dummy.next;
+}
+
+// Function to cut a chain after count nodes
+// Terminates the chain after its count-th node and returns the rest (NULL if it was shorter).
+struct Node* cutAfter(struct Node* node, int count) {
+    for (int i = 1; node != NULL && i < count; i++) {
+        node = node->next;
+    }
+    if (node == NULL) return NULL;
+    struct Node* rest = node->next;
+    node->next = NULL;
+    return rest;
+}
+
+// Function to merge a sorted list into another sorted list
+// Moves every node of src into dest in sorted order and leaves src empty.
+void mergeLists(struct List* dest, struct List* src) {
+    if (src->head == NULL) return;
+    struct Node* tail;
+    dest->head = mergeChains(dest->head, src->head, &tail);
+    dest->tail = tail;
+    dest->size += src->size;
+    initList(src);
+}
+
+// Function to sort the list in ascending order
+// Bottom-up merge sort: pass k merges neighbouring sorted runs of 2^k nodes. It only relinks
+// existing nodes, so it needs no recursion and no extra memory, and runs in O(n log n).
+void sortList(struct List* list) {
+    if (list->size < 2) return;
+    for (int width = 1; width < list->size; width *= 2) {
+        struct Node dummy;
+        struct Node* last = &dummy;
+        struct Node* current = list->head;
+        while (current != NULL) {
+            struct Node* left = current;
+            struct Node* right = cutAfter(left, width);   // Second run starts here
+            current = cutAfter(right, width);             // Remaining nodes for the next pair
+            struct Node* mergedTail;
+            last->next = mergeChains(left, right, &mergedTail);
+            last = mergedTail;
+        }
+        list->head = dummy.next;
+        list->tail = last;
+    }
+}
+
+// Function to delete the whole list
+// Releases every node and leaves the list empty.
+void deleteList(struct List* list) {
+    struct Node* current = list->head;
+    while (current != NULL) {
+        struct Node* nextNode = current->next;
+        freeNode(current);
+        current = nextNode;
+    }
+    initList(list);
+}
+
+// Function to save the list to a file
+// Writes the values in list order in the flat format of listFile.h. Returns 0 on success.
+int saveList(struct List* list, const char* path) {
+    ListFileWriter writer;
+    if (listFileCreate(&writer, path, (uint64_t)list->size) != 0) return -1;
+    for (struct Node* node = list->head; node != NULL; node = node->next) {
+        listFilePut(&writer, node->data);
+    }
+    return listFileClose(&writer);
+}
+
+// Function to load a list saved by saveList
+// Maps the file and appends its values with buildFromArray, reading them in place
+// instead of copying them into a buffer first. Returns 0 on success.
+int loadList(struct List* list, const char* path) {
+    ListFileMapping file;
+    if (listFileMap(&file, path) != 0) return -1;
+    if (file.count > (uint64_t)(INT_MAX - list->size)) {
+        printf("%s holds too many values for one list.\n", path);
+        listFileUnmap(&file);
+        return -1;
+    }
+    buildFromArray(list, file.values, (int)file.count);
+    listFileUnmap(&file);
+    return 0;
+}
+
+// Function to get a monotonic timestamp in seconds
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Function to sum the values of the list
+// Used by the benchmark to check that a restored list matches the saved one.
+long long sumList(struct List* list) {
+    long long sum = 0;
+    for (struct Node* node = list->head; node != NULL; node = node->next) {
+        sum += node->data;
+    }
+    return sum;
+}
+
+// Function to benchmark saving and restoring a list of n elements
+// Compares restoring by reading the file and calling insertAtEnd for every value with
+// loadList, which maps the file and builds the list in one pass.
+void benchmarkSaveLoad(int n, const char* path) {
+    struct List list;
+    initList(&list);
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        insertAtEnd(&list, (int)(seed >> 8));
+    }
+    long long expected = sumList(&list);
+    double megabytes = (sizeof(ListFileHeader) + (double)n * sizeof(int)) / 1e6;
+
+    double start = nowSeconds();
+    if (saveList(&list, path) != 0) {
+        deleteList(&list);
+        remove(path);
+        return;
+    }
+    double elapsed = nowSeconds() - start;
+    printf("save            : %8.1f ms  %7.1f M elements/s  %7.1f MB/s\n",
+           elapsed * 1e3, n / elapsed / 1e6, megabytes / elapsed);
+    deleteList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool); // Both restores start from an empty pool
+#endif
+
+    // Restore node by node: fread the values and append them one by one.
+    start = nowSeconds();
+    FILE* file = fopen(path, "rb");
+    ListFileHeader header;
+    int buffer[LIST_FILE_BUFFER];
+    size_t got;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1) {
+        printf("Cannot read %s.\n", path);
+        if (file != NULL) fclose(file);
+        remove(path);
+        return;
+    }
+    while ((got = fread(buffer, sizeof(int), LIST_FILE_BUFFER, file)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            insertAtEnd(&list, buffer[i]);
+        }
+    }
+    fclose(file);
+    elapsed = nowSeconds() - start;
+    printf("insertAtEnd load: %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    deleteList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool);
+#endif
+
+    // Restore with loadList: mmap plus one bulk build.
+    start = nowSeconds();
+    if (loadList(&list, path) != 0) {
+        deleteList(&list);
+        remove(path);
+        return;
+    }
+    elapsed = nowSeconds() - start;
+    printf("mmap load       : %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    deleteList(&list);
+    remove(path);
 }
 
 // Function to print the linked list
 // Prints each node's data sequentially, ending with NULL.
-void printList(struct Node* node) {
+void printList(struct List* list) {
+    struct Node* node = list->head;
     while (node != NULL) {
         printf("%d -> ", node->data);
         node = node->next;
@@ -137,50 +459,100 @@ void printList(struct Node* node) {
     printf("NULL\n");
 }
 
-int main() {
-    struct Node* head = NULL; // Initialize the list as empty
+// Usage: ./singleLinkedList [benchmarkElements]
+// Without an argument only the demo runs; with one, saving and restoring a list of that
+// many elements is benchmarked as well (e.g. 100000000).
+int main(int argc, char* argv[]) {
+    struct List list;
+    initList(&list); // Initialize the list as empty
 
     // Append elements to the list
     printf("Initial list:\n");
-    insertAtEnd(&head, 10);
-    insertAtEnd(&head, 20);
-    insertAtEnd(&head, 30);
-    printList(head);
+    insertAtEnd(&list, 10);
+    insertAtEnd(&list, 20);
+    insertAtEnd(&list, 30);
+    printList(&list);
 
     // Insert at the beginning
     printf("\nInsert 5 at the beginning:\n");
-    insertAtBeginning(&head, 5);
-    printList(head);
+    insertAtBeginning(&list, 5);
+    printList(&list);
 
     // Append another element
     printf("\nAppend 40 to the list:\n");
-    insertAtEnd(&head, 40);
-    printList(head);
+    insertAtEnd(&list, 40);
+    printList(&list);
 
     // Insert after a given index (inserting 25 after index 1, which means after the second node)
     printf("\nInsert 25 after index 1:\n");
-    insertAfterIndex(&head, 25, 2);
-    printList(head);
+    insertAfterIndex(&list, 25, 2);
+    printList(&list);
 
     // Delete the first node
     printf("\nDelete from the beginning:\n");
-    deleteFromBeginning(&head);
-    printList(head);
+    deleteFromBeginning(&list);
+    printList(&list);
 
     // Delete a node at a given index (delete node at index 2)
     printf("\nDelete node at index 2:\n");
-    deleteAtIndex(&head, 2);
-    printList(head);
+    deleteAtIndex(&list, 2);
+    printList(&list);
 
     // Delete the last node
     printf("\nDelete from the end:\n");
-    deleteFromEnd(&head);
-    printList(head);
+    deleteFromEnd(&list);
+    printList(&list);
 
     // Reverse the list
     printf("\nReverse the list:\n");
-    reverseList(&head);
-    printList(head);
+    reverseList(&list);
+    printList(&list);
+    printf("List size: %d\n", listSize(&list));
+
+    // Build a second list from an array and append it in O(1)
+    printf("\nBuild [7, 3, 9, 1] from an array and splice it onto the list:\n");
+    int values[] = {7, 3, 9, 1};
+    struct List other;
+    initList(&other);
+    buildFromArray(&other, values, 4);
+    spliceLists(&list, &other);
+    printList(&list);
 
+    // Sort the list
+    printf("\nSort the list:\n");
+    sortList(&list);
+    printList(&list);
+
+    // Split the list at index 3 and merge the halves back in sorted order
+    printf("\nSplit at index 3:\n");
+    splitAtIndex(&list, 3, &other);
+    printList(&list);
+    printList(&other);
+    printf("\nMerge the sorted halves:\n");
+    mergeLists(&list, &other);
+    printList(&list);
+
+    // Save the list to a file and load it back
+    printf("\nSave to list.bin and load it into a new list:\n");
+    if (saveList(&list, "list.bin") == 0 && loadList(&other, "list.bin") == 0) {
+        printList(&other);
+        printf("List size: %d\n", listSize(&other));
+    }
+    remove("list.bin");
+    deleteList(&other);
+    deleteList(&list);
+
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n <= 0) {
+            printf("Usage: %s [benchmarkElements]\n", argv[0]);
+            return 1;
+        }
+        printf("\nSave/restore of %d elements:\n", n);
+        benchmarkSaveLoad(n, "list-benchmark.bin");
+    }
+#ifdef USE_NODE_POOL
+    poolDestroy(&nodePool); // Release the pool's slabs in one call
+#endif
     return 0;
 }
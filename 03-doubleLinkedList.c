@@ -1,5 +1,10 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include "listFile.h"
 
 // Doubly linked list node structure
 struct Node {
@@ -8,133 +13,183 @@ struct Node {
     struct Node* prev;  // Pointer to the previous node
 };
 
+// Doubly linked list handle
+// Keeps both ends of the list and its length, so append, pop-back and size are O(1).
+struct List {
+    struct Node* head;  // First node, NULL when the list is empty
+    struct Node* tail;  // Last node, NULL when the list is empty
+    int size;           // Number of nodes in the list
+};
+
+// Node allocation
+// Compile with -DUSE_NODE_POOL to take nodes from the slab allocator in nodePool.h
+// instead of calling malloc/free for every node.
+#ifdef USE_NODE_POOL
+#include "nodePool.h"
+static NodePool nodePool = NODE_POOL_INITIALIZER(sizeof(struct Node));
+#endif
+
 // Function to create a new node
 // Allocates memory for a new node, sets the data, and initializes both pointers to NULL.
 struct Node* createNode(int data) {
+#ifdef USE_NODE_POOL
+    struct Node* newNode = (struct Node*)poolAlloc(&nodePool);         // Take a node from the pool
+#else
     struct Node* newNode = (struct Node*)malloc(sizeof(struct Node)); // Allocate memory for the new node
+#endif
     newNode->data = data;      // Set the node's data
     newNode->next = NULL;      // Initialize next pointer to NULL
     newNode->prev = NULL;      // Initialize previous pointer to NULL
     return newNode;            // Return the new node
 }
 
+// Function to release a node
+// Returns the node to the pool when USE_NODE_POOL is set, otherwise frees it.
+void freeNode(struct Node* node) {
+#ifdef USE_NODE_POOL
+    poolFree(&nodePool, node);
+#else
+    free(node);
+#endif
+}
+
+// Function to initialize a list
+// Sets up an empty list: no head, no tail and a size of zero.
+void initList(struct List* list) {
+    list->head = NULL;                         // No first node yet
+    list->tail = NULL;                         // No last node yet
+    list->size = 0;                            // Empty list
+}
+
+// Function to get the number of nodes in the list
+// The size is kept up to date by every operation, so no traversal is needed.
+int listSize(struct List* list) {
+    return list->size;
+}
+
+// Function to find the node at a given index (0-based)
+// Walks from whichever end of the list is closer to the index.
+struct Node* nodeAt(struct List* list, int index) {
+    if (index < 0 || index >= list->size) return NULL; // Index out of bounds
+    struct Node* temp;
+    if (index < list->size / 2) {
+        temp = list->head;                     // Walk forward from the head
+        for (int i = 0; i < index; i++) {
+            temp = temp->next;
+        }
+    } else {
+        temp = list->tail;                     // Walk backward from the tail
+        for (int i = list->size - 1; i > index; i--) {
+            temp = temp->prev;
+        }
+    }
+    return temp;
+}
+
 // Function to insert a node at the beginning of the list
 // Updates the head pointer to point to the new node.
-void insertAtBeginning(struct Node** head, int data) {
-    struct Node* newNode = createNode(data); // Create a new node
-    if (*head == NULL) {                       // If the list is empty
-        *head = newNode;                       // Set new node as head
-        return;
+void insertAtBeginning(struct List* list, int data) {
+    struct Node* newNode = createNode(data);   // Create a new node
+    if (list->head == NULL) {                  // If the list is empty
+        list->head = list->tail = newNode;     // The new node is both head and tail
+    } else {
+        newNode->next = list->head;            // Link new node's next to current head
+        list->head->prev = newNode;            // Link current head's previous to new node
+        list->head = newNode;                  // Update head to the new node
     }
-    newNode->next = *head;                     // Link new node's next to current head
-    (*head)->prev = newNode;                   // Link current head's previous to new node
-    *head = newNode;                           // Update head to the new node
+    list->size++;
 }
 
 // Function to insert a node at the end of the list
-// Traverses to the end and appends the new node.
-void insertAtEnd(struct Node** head, int data) {
+// Links the new node after the tail, so no traversal is needed.
+void insertAtEnd(struct List* list, int data) {
     struct Node* newNode = createNode(data);   // Create a new node
-    if (*head == NULL) {                       // If the list is empty
-        *head = newNode;                       // Set new node as head
-        return;
-    }
-    struct Node* tail = *head;                 // Start from the head
-    while (tail->next != NULL) {               // Traverse to the last node
-        tail = tail->next;
+    if (list->tail == NULL) {                  // If the list is empty
+        list->head = list->tail = newNode;     // The new node is both head and tail
+    } else {
+        list->tail->next = newNode;            // Append the new node after the last node
+        newNode->prev = list->tail;            // Link new node's previous to the tail
+        list->tail = newNode;                  // The new node is the new tail
     }
-    tail->next = newNode;                      // Append the new node after the last node
-    newNode->prev = tail;                      // Link new node's previous to the tail
+    list->size++;
 }
 
 // Function to insert a node after a given index (0-based)
 // Inserts the new node after the node at the specified index.
-void insertAfterIndex(struct Node** head, int data, int index) {
-    struct Node* newNode = createNode(data);   // Create a new node
+void insertAfterIndex(struct List* list, int data, int index) {
+    if (index < 0 || index > list->size) return; // If index is out of bounds, exit
 
-    // Insertion at beginning if index is 0
+    // Insertion at either end does not need a walk
     if (index == 0) {
-        newNode->next = *head;
-        newNode->prev = NULL;
-        if (*head != NULL) {                   // If the list is not empty
-            (*head)->prev = newNode;
-        }
-        *head = newNode;
+        insertAtBeginning(list, data);
         return;
     }
-
-    struct Node* temp = *head;                 // Start from the head
-    // Traverse to the node at (index - 1) position
-    for (int i = 0; i < index - 1; i++) {
-        if (temp == NULL) return;              // If index is out of bounds, exit
-        temp = temp->next;
+    if (index == list->size) {
+        insertAtEnd(list, data);
+        return;
     }
+
+    struct Node* temp = nodeAt(list, index - 1); // Node at (index - 1) position
+    struct Node* newNode = createNode(data);   // Create a new node
     newNode->next = temp->next;                // Link new node's next to temp's next
     newNode->prev = temp;                      // Link new node's previous to temp
-    if (temp->next != NULL) {                  // If there is a node after temp
-        temp->next->prev = newNode;            // Update that node's previous pointer to the new node
-    }
+    temp->next->prev = newNode;                // Update the following node's previous pointer to the new node
     temp->next = newNode;                      // Link temp's next to the new node
+    list->size++;
 }
 
 // Function to delete the node from the beginning of the list
-void deleteFromBeginning(struct Node** head) {
-    if (*head == NULL) return;                 // If the list is empty, do nothing
-    struct Node* temp = *head;                 // Store the current head
-    *head = (*head)->next;                     // Update head to the next node
-    if (*head != NULL) {                       // If the list is not empty after deletion
-        (*head)->prev = NULL;                  // Set new head's previous pointer to NULL
+void deleteFromBeginning(struct List* list) {
+    if (list->head == NULL) return;            // If the list is empty, do nothing
+    struct Node* temp = list->head;            // Store the current head
+    list->head = temp->next;                   // Update head to the next node
+    if (list->head != NULL) {                  // If the list is not empty after deletion
+        list->head->prev = NULL;               // Set new head's previous pointer to NULL
+    } else {
+        list->tail = NULL;                     // The list became empty
     }
-    free(temp);                                // Free the memory of the old head
+    freeNode(temp);                            // Free the memory of the old head
+    list->size--;
 }
 
 // Function to delete the node from the end of the list
-void deleteFromEnd(struct Node** head) {
-    if (*head == NULL) return;                 // If the list is empty, do nothing
-    if ((*head)->next == NULL) {               // If there is only one node in the list
-        free(*head);                         // Free it
-        *head = NULL;
-        return;
-    }
-    struct Node* tail = *head;                 // Start from the head
-    while (tail->next != NULL) {               // Traverse to the last node
-        tail = tail->next;
+// The tail's previous pointer gives the new tail, so no traversal is needed.
+void deleteFromEnd(struct List* list) {
+    if (list->tail == NULL) return;            // If the list is empty, do nothing
+    struct Node* temp = list->tail;            // Store the current tail
+    list->tail = temp->prev;                   // Update tail to the previous node
+    if (list->tail != NULL) {                  // If the list is not empty after deletion
+        list->tail->next = NULL;               // Set new tail's next pointer to NULL
+    } else {
+        list->head = NULL;                     // The list became empty
     }
-    tail->prev->next = NULL;                   // Update the second-last node's next pointer to NULL
-    free(tail);                                // Free the last node
+    freeNode(temp);                            // Free the last node
+    list->size--;
 }
 
 // Function to delete a node at a given index (0-based)
 // Deletes the node located at the specified index.
-void deleteAtIndex(struct Node** head, int index) {
-    if (*head == NULL) return;                 // If the list is empty, do nothing
-    struct Node* temp = *head;
-    if (index == 0) {                          // If deleting the first node
-        *head = temp->next;                    // Update head to the next node
-        if (*head != NULL) {
-            (*head)->prev = NULL;              // Set new head's previous pointer to NULL
-        }
-        free(temp);                            // Free the old head
-        return;
-    }
-    // Traverse to the node at the given index
-    for (int i = 0; temp != NULL && i < index; i++) {
-        temp = temp->next;
-    }
+void deleteAtIndex(struct List* list, int index) {
+    struct Node* temp = nodeAt(list, index);   // Find the node to delete
     if (temp == NULL) return;                  // If index is out of bounds, do nothing
-    if (temp->next != NULL) {                  // If there is a node after the node to be deleted
-        temp->next->prev = temp->prev;         // Update its previous pointer
+    if (temp == list->head) {                  // If deleting the first node
+        deleteFromBeginning(list);
+        return;
     }
-    if (temp->prev != NULL) {                  // If there is a node before the node to be deleted
-        temp->prev->next = temp->next;         // Update its next pointer
+    if (temp == list->tail) {                  // If deleting the last node
+        deleteFromEnd(list);
+        return;
     }
-    free(temp);                                // Free the node
+    temp->next->prev = temp->prev;             // Update the following node's previous pointer
+    temp->prev->next = temp->next;             // Update the preceding node's next pointer
+    freeNode(temp);                            // Free the node
+    list->size--;
 }
 
 // Function to reverse the doubly linked list
 // Reverses the order of the nodes in the list.
-void reverseList(struct Node** head) {
-    struct Node* current = *head;              // Start from the head
+void reverseList(struct List* list) {
+    struct Node* current = list->head;         // Start from the head
     struct Node* temp = NULL;                  // Temporary pointer for swapping
     while (current != NULL) {
         // Swap the previous and next pointers of the current node
@@ -143,14 +198,284 @@ void reverseList(struct Node** head) {
         current->next = temp;
         current = current->prev;               // Move to the next node (using prev due to swap)
     }
-    if (temp != NULL) {
-        *head = temp->prev;                    // Update head to the new first node
+    temp = list->head;                         // Swap head and tail
+    list->head = list->tail;
+    list->tail = temp;
+}
+
+// Function to append the values of an array to the list
+// Creates the nodes in one pass and links each one straight after the previous one,
+// so there is no per-value call or tail lookup. With USE_NODE_POOL all nodes are taken
+// from the pool as one contiguous block, so the new chain lies in memory in list order.
+void buildFromArray(struct List* list, const int* values, int count) {
+    if (count <= 0) return;
+#ifdef USE_NODE_POOL
+    char* block = (char*)poolAllocBlock(&nodePool, count);
+#endif
+    struct Node* last = list->tail;            // New nodes are linked after the current tail
+    for (int i = 0; i < count; i++) {
+#ifdef USE_NODE_POOL
+        struct Node* newNode = (struct Node*)(block + (size_t)i * nodePool.nodeSize);
+        newNode->data = values[i];
+#else
+        struct Node* newNode = createNode(values[i]);
+#endif
+        newNode->prev = last;                  // Link back to the previous node
+        if (last == NULL) {
+            list->head = newNode;              // First node of an empty list
+        } else {
+            last->next = newNode;              // Link forward to the new node
+        }
+        last = newNode;
+    }
+    last->next = NULL;
+    list->tail = last;
+    list->size += count;
+}
+
+// Function to concatenate two lists in O(1)
+// Moves every node of src to the end of dest and leaves src empty.
+void spliceLists(struct List* dest, struct List* src) {
+    if (src->head == NULL) return;             // Nothing to move
+    if (dest->tail == NULL) {                  // If dest is empty, it simply takes over src
+        dest->head = src->head;
+    } else {
+        dest->tail->next = src->head;          // Join the two ends
+        src->head->prev = dest->tail;
+    }
+    dest->tail = src->tail;
+    dest->size += src->size;
+    initList(src);
+}
+
+// Function to split the list at a given index (0-based)
+// Nodes from index onward are moved into rest (which is overwritten); list keeps the first index nodes.
+void splitAtIndex(struct List* list, int index, struct List* rest) {
+    initList(rest);
+    struct Node* first = nodeAt(list, index);  // First node of the second part
+    if (first == NULL) return;                 // Index out of bounds, nothing to move
+    rest->head = first;
+    rest->tail = list->tail;
+    rest->size = list->size - index;
+    list->tail = first->prev;                  // The node before the cut ends the first part
+    list->size = index;
+    if (list->tail != NULL) {
+        list->tail->next = NULL;
+    } else {
+        list->head = NULL;                     // Split at index 0: everything moved
+    }
+    first->prev = NULL;
+}
+
+// Function to merge two sorted chains of nodes
+// Follows next pointers only; the caller repairs the prev pointers afterwards. Returns the
+// head of the merged chain. Equal values keep their order (a before b), so the sort is stable.
+struct Node* mergeChains(struct Node* a, struct Node* b, struct Node** tail) {
+    struct Node dummy;
+    struct Node* last = &dummy;
+    while (a != NULL && b != NULL) {
+        if (b->data < a->data) {
+            last->next = b;
+            b = b->next;
+        } else {
+            last->next = a;
+            a = a->next;
+        }
+        last = last->next;
+    }
+    last->next = (a != NULL) ? a : b;          // Append whatever is left
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    *tail = last;
+    return dummy.next;
+}
+
+// Function to cut a chain after count nodes
+// Terminates the chain after its count-th node and returns the rest (NULL if it was shorter).
+struct Node* cutAfter(struct Node* node, int count) {
+    for (int i = 1; node != NULL && i < count; i++) {
+        node = node->next;
+    }
+    if (node == NULL) return NULL;
+    struct Node* rest = node->next;
+    node->next = NULL;
+    return rest;
+}
+
+// Function to rebuild the prev pointers from the next pointers
+// Used after merging, which only relinks next pointers.
+void fixPrevLinks(struct List* list) {
+    struct Node* prev = NULL;
+    for (struct Node* node = list->head; node != NULL; node = node->next) {
+        node->prev = prev;
+        prev = node;
+    }
+    list->tail = prev;
+}
+
+// Function to merge a sorted list into another sorted list
+// Moves every node of src into dest in sorted order and leaves src empty.
+void mergeLists(struct List* dest, struct List* src) {
+    if (src->head == NULL) return;
+    struct Node* tail;
+    dest->head = mergeChains(dest->head, src->head, &tail);
+    dest->size += src->size;
+    fixPrevLinks(dest);
+    initList(src);
+}
+
+// Function to sort the list in ascending order
+// Bottom-up merge sort: pass k merges neighbouring sorted runs of 2^k nodes through their next
+// pointers, and one final pass repairs the prev pointers. It only relinks existing nodes, so it
+// needs no recursion and no extra memory, and runs in O(n log n).
+void sortList(struct List* list) {
+    if (list->size < 2) return;
+    for (int width = 1; width < list->size; width *= 2) {
+        struct Node dummy;
+        struct Node* last = &dummy;
+        struct Node* current = list->head;
+        while (current != NULL) {
+            struct Node* left = current;
+            struct Node* right = cutAfter(left, width);   // Second run starts here
+            current = cutAfter(right, width);             // Remaining nodes for the next pair
+            struct Node* mergedTail;
+            last->next = mergeChains(left, right, &mergedTail);
+            last = mergedTail;
+        }
+        list->head = dummy.next;
+    }
+    fixPrevLinks(list);
+}
+
+// Function to delete the whole list
+// Releases every node and leaves the list empty.
+void deleteList(struct List* list) {
+    struct Node* current = list->head;
+    while (current != NULL) {
+        struct Node* nextNode = current->next; // Save the next node before releasing this one
+        freeNode(current);
+        current = nextNode;
+    }
+    initList(list);
+}
+
+// Function to save the list to a file
+// Writes the values from head to tail in the flat format of listFile.h. Returns 0 on success.
+int saveList(struct List* list, const char* path) {
+    ListFileWriter writer;
+    if (listFileCreate(&writer, path, (uint64_t)list->size) != 0) return -1;
+    for (struct Node* node = list->head; node != NULL; node = node->next) {
+        listFilePut(&writer, node->data);
+    }
+    return listFileClose(&writer);
+}
+
+// Function to load a list saved by saveList
+// Maps the file and appends its values with buildFromArray, reading them in place
+// instead of copying them into a buffer first. Returns 0 on success.
+int loadList(struct List* list, const char* path) {
+    ListFileMapping file;
+    if (listFileMap(&file, path) != 0) return -1;
+    if (file.count > (uint64_t)(INT_MAX - list->size)) {
+        printf("%s holds too many values for one list.\n", path);
+        listFileUnmap(&file);
+        return -1;
+    }
+    buildFromArray(list, file.values, (int)file.count);
+    listFileUnmap(&file);
+    return 0;
+}
+
+// Function to get a monotonic timestamp in seconds
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Function to sum the values of the list
+// Walks backward, so the benchmark also checks the prev links of a restored list.
+long long sumList(struct List* list) {
+    long long sum = 0;
+    for (struct Node* node = list->tail; node != NULL; node = node->prev) {
+        sum += node->data;
+    }
+    return sum;
+}
+
+// Function to benchmark saving and restoring a list of n elements
+// Compares restoring by reading the file and calling insertAtEnd for every value with
+// loadList, which maps the file and builds the list in one pass.
+void benchmarkSaveLoad(int n, const char* path) {
+    struct List list;
+    initList(&list);
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        insertAtEnd(&list, (int)(seed >> 8));
+    }
+    long long expected = sumList(&list);
+    double megabytes = (sizeof(ListFileHeader) + (double)n * sizeof(int)) / 1e6;
+
+    double start = nowSeconds();
+    if (saveList(&list, path) != 0) {
+        deleteList(&list);
+        remove(path);
+        return;
+    }
+    double elapsed = nowSeconds() - start;
+    printf("save            : %8.1f ms  %7.1f M elements/s  %7.1f MB/s\n",
+           elapsed * 1e3, n / elapsed / 1e6, megabytes / elapsed);
+    deleteList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool);                 // Both restores start from an empty pool
+#endif
+
+    // Restore node by node: fread the values and append them one by one
+    start = nowSeconds();
+    FILE* file = fopen(path, "rb");
+    ListFileHeader header;
+    int buffer[LIST_FILE_BUFFER];
+    size_t got;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1) {
+        printf("Cannot read %s.\n", path);
+        if (file != NULL) fclose(file);
+        remove(path);
+        return;
     }
+    while ((got = fread(buffer, sizeof(int), LIST_FILE_BUFFER, file)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            insertAtEnd(&list, buffer[i]);
+        }
+    }
+    fclose(file);
+    elapsed = nowSeconds() - start;
+    printf("insertAtEnd load: %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    deleteList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool);
+#endif
+
+    // Restore with loadList: mmap plus one bulk build
+    start = nowSeconds();
+    if (loadList(&list, path) != 0) {
+        deleteList(&list);
+        remove(path);
+        return;
+    }
+    elapsed = nowSeconds() - start;
+    printf("mmap load       : %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    deleteList(&list);
+    remove(path);
 }
 
 // Function to print the doubly linked list
 // Prints each node's data in order until the end of the list.
-void printList(struct Node* node) {
+void printList(struct List* list) {
+    struct Node* node = list->head;            // Start from the head
     while (node != NULL) {
         printf("%d -> ", node->data);        // Print the node's data
         node = node->next;                     // Move to the next node
@@ -158,51 +483,101 @@ void printList(struct Node* node) {
     printf("NULL\n");                          // Indicate the end of the list
 }
 
-int main() {
-    struct Node* head = NULL;  // Initialize the doubly linked list as empty
+// Usage: ./doubleLinkedList [benchmarkElements]
+// Without an argument only the demo runs; with one, saving and restoring a list of that
+// many elements is benchmarked as well (e.g. 100000000).
+int main(int argc, char* argv[]) {
+    struct List list;
+    initList(&list);           // Initialize the doubly linked list as empty
 
     // Insert nodes at the end
     printf("Initial list:\n");
-    insertAtEnd(&head, 10); // Append 10
-    insertAtEnd(&head, 20); // Append 20
-    insertAtEnd(&head, 30); // Append 30
-    printList(head);
+    insertAtEnd(&list, 10); // Append 10
+    insertAtEnd(&list, 20); // Append 20
+    insertAtEnd(&list, 30); // Append 30
+    printList(&list);
 
     // Insert node at the beginning
     printf("\nInsert 5 at the beginning:\n");
-    insertAtBeginning(&head, 5);  // Prepend 5
-    printList(head);
+    insertAtBeginning(&list, 5);  // Prepend 5
+    printList(&list);
 
     // Insert node at the end
     printf("\nInsert 40 at the end:\n");
-    insertAtEnd(&head, 40); // Append 40
-    printList(head);
+    insertAtEnd(&list, 40); // Append 40
+    printList(&list);
 
     // Insert node after a given index (insert 25 after index 1)
     printf("\nInsert 25 after index 1:\n");
-    insertAfterIndex(&head, 25, 2); // Insert 25 after the node at index 1
-    printList(head);
+    insertAfterIndex(&list, 25, 2); // Insert 25 after the node at index 1
+    printList(&list);
 
     // Delete node from the beginning
     printf("\nDelete from the beginning:\n");
-    deleteFromBeginning(&head);
-    printList(head);
+    deleteFromBeginning(&list);
+    printList(&list);
 
     // Delete node at index 2
     printf("\nDelete node at index 2:\n");
-    deleteAtIndex(&head, 2);
-    printList(head);
+    deleteAtIndex(&list, 2);
+    printList(&list);
 
     // Delete node from the end
     printf("\nDelete from the end:\n");
-    deleteFromEnd(&head);
-    printList(head);
+    deleteFromEnd(&list);
+    printList(&list);
 
     // Reverse the list
     printf("\nReverse the list:\n");
-    reverseList(&head);
-    printList(head);
+    reverseList(&list);
+    printList(&list);
+    printf("List size: %d\n", listSize(&list));
+
+    // Build a second list from an array and append it in O(1)
+    printf("\nBuild [7, 3, 9, 1] from an array and splice it onto the list:\n");
+    int values[] = {7, 3, 9, 1};
+    struct List other;
+    initList(&other);
+    buildFromArray(&other, values, 4);
+    spliceLists(&list, &other);
+    printList(&list);
 
+    // Sort the list
+    printf("\nSort the list:\n");
+    sortList(&list);
+    printList(&list);
+
+    // Split the list at index 3 and merge the halves back in sorted order
+    printf("\nSplit at index 3:\n");
+    splitAtIndex(&list, 3, &other);
+    printList(&list);
+    printList(&other);
+    printf("\nMerge the sorted halves:\n");
+    mergeLists(&list, &other);
+    printList(&list);
+
+    // Save the list to a file and load it back
+    printf("\nSave to list.bin and load it into a new list:\n");
+    if (saveList(&list, "list.bin") == 0 && loadList(&other, "list.bin") == 0) {
+        printList(&other);
+        printf("List size: %d\n", listSize(&other));
+    }
+    remove("list.bin");
+    deleteList(&other);
+    deleteList(&list);
+
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n <= 0) {
+            printf("Usage: %s [benchmarkElements]\n", argv[0]);
+            return 1;
+        }
+        printf("\nSave/restore of %d elements:\n", n);
+        benchmarkSaveLoad(n, "list-benchmark.bin");
+    }
+#ifdef USE_NODE_POOL
+    poolDestroy(&nodePool); // Release the pool's slabs in one call
+#endif
     return 0;
 }
 
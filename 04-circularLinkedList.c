@@ -1,5 +1,10 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include "listFile.h"
 
 // Define the Node structure for the circular linked list.
 typedef struct Node {
@@ -7,13 +12,26 @@ typedef struct Node {
     struct Node* next;     // Pointer to the next node in the list.
 } Node;
 
+/*
+ * Node allocation: Compile with -DUSE_NODE_POOL to take nodes from the slab allocator
+ * in nodePool.h instead of calling malloc/free for every node.
+ */
+#ifdef USE_NODE_POOL
+#include "nodePool.h"
+static NodePool nodePool = NODE_POOL_INITIALIZER(sizeof(Node));
+#endif
+
 /*
  * createNode: Allocates and initializes a new node with the given data.
  * Explanation: This function allocates memory for a new node, sets its data field,
  * and makes its next pointer point to itself, since it will be used in a circular list.
  */
 Node* createNode(int data) {
+#ifdef USE_NODE_POOL
+    Node* newNode = (Node*)poolAlloc(&nodePool);
+#else
     Node* newNode = (Node*)malloc(sizeof(Node));
+#endif
     if(newNode == NULL) {
         printf("Memory allocation failed.\n");
         exit(1);
@@ -24,169 +42,553 @@ Node* createNode(int data) {
 }
 
 /*
- * insertAtBeginning: Inserts a new node at the beginning of the circular linked list.
- * Explanation: If the list is empty, the new node becomes the head.
- * Otherwise, the function finds the last node, updates its next pointer to the new node,
- * and makes the new node point to the previous head. The new node becomes the new head.
+ * freeNode: Releases a node created by createNode.
+ * Explanation: Returns the node to the pool when USE_NODE_POOL is set, otherwise frees it.
  */
-Node* insertAtBeginning(Node* head, int data) {
-    Node* newNode = createNode(data);
-    if(head == NULL) {
-        // List is empty: the new node is the head.
-        return newNode;
+void freeNode(Node* node) {
+#ifdef USE_NODE_POOL
+    poolFree(&nodePool, node);
+#else
+    free(node);
+#endif
+}
+
+/*
+ * ValueIndex: Optional open-addressing hash index over the values of a circular list.
+ * Explanation: A singly linked node cannot be unlinked without its predecessor, so each entry
+ * maps a value to the node *before* the node holding it. Search, delete-by-key and
+ * insert-after-key then find their node (and its predecessor) in expected O(1).
+ * Duplicate values get one entry each; an entry is identified by its value and predecessor.
+ */
+#define INDEX_EMPTY 0      // Slot was never used.
+#define INDEX_USED 1       // Slot holds an entry.
+#define INDEX_DELETED 2    // Slot held an entry that was removed (tombstone).
+
+typedef struct {
+    int key;               // Value of the indexed node.
+    int state;             // INDEX_EMPTY, INDEX_USED or INDEX_DELETED.
+    Node* prev;            // Node whose next pointer is the indexed node.
+} IndexEntry;
+
+typedef struct {
+    IndexEntry* slots;     // Hash table, capacity is a power of two.
+    int capacity;          // Number of slots.
+    int shift;             // 32 - log2(capacity), for hashKey.
+    int used;              // Slots in state INDEX_USED.
+    int filled;            // Slots in state INDEX_USED or INDEX_DELETED.
+} ValueIndex;
+
+/*
+ * CircularList: Handle for a circular linked list.
+ * Explanation: Keeps the head, the tail (so both ends can be reached without walking the ring)
+ * and the node count. When index is not NULL every mutation keeps it up to date.
+ */
+typedef struct {
+    Node* head;            // First node, NULL when the list is empty.
+    Node* tail;            // Last node; its next pointer is head.
+    int count;             // Number of nodes in the list.
+    ValueIndex* index;     // Optional value index, NULL when disabled.
+} CircularList;
+
+/*
+ * hashKey: Spreads an int key over a table of 2^(32 - shift) slots (Fibonacci hashing).
+ * Explanation: The key is multiplied by 2^32 / golden ratio and the top bits of the product are
+ * used. The low bits would not do: they depend only on the low bits of the key, so keys with a
+ * power-of-two stride would all land in the same slot.
+ */
+unsigned int hashKey(int key, int shift) {
+    return ((unsigned int)key * 2654435769u) >> shift;
+}
+
+/*
+ * indexShift: Returns the shift hashKey needs for a power-of-two capacity (at least 2).
+ */
+int indexShift(int capacity) {
+    int shift = 32;
+    while(capacity > 1) {
+        capacity >>= 1;
+        shift--;
     }
-    Node* curr = head;
-    // Traverse to the last node (whose next pointer points to head).
-    while(curr->next != head) {
-        curr = curr->next;
+    return shift;
+}
+
+/*
+ * createIndex: Allocates an empty index with the given power-of-two capacity.
+ */
+ValueIndex* createIndex(int capacity) {
+    ValueIndex* index = (ValueIndex*)malloc(sizeof(ValueIndex));
+    if(index == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    index->slots = (IndexEntry*)calloc(capacity, sizeof(IndexEntry));
+    if(index->slots == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
     }
-    curr->next = newNode;  // Last node now points to the new node.
-    newNode->next = head;  // New node points to the old head.
-    return newNode;        // New node is the new head.
+    index->capacity = capacity;
+    index->shift = indexShift(capacity);
+    index->used = 0;
+    index->filled = 0;
+    return index;
 }
 
 /*
- * insertAtEnd: Inserts a new node at the end of the circular linked list.
- * Explanation: If the list is empty, the new node becomes the head.
- * Otherwise, the function finds the last node and inserts the new node after it.
- * The new node's next pointer is set to point to head.
+ * freeIndex: Releases the index.
  */
-Node* insertAtEnd(Node* head, int data) {
-    Node* newNode = createNode(data);
-    if(head == NULL) {
-        return newNode;
+void freeIndex(ValueIndex* index) {
+    if(index == NULL)
+        return;
+    free(index->slots);
+    free(index);
+}
+
+void indexAdd(ValueIndex* index, int key, Node* prev);
+
+/*
+ * indexResize: Rebuilds the table with a new capacity, dropping tombstones.
+ */
+void indexResize(ValueIndex* index, int capacity) {
+    IndexEntry* old = index->slots;
+    int oldCapacity = index->capacity;
+    index->slots = (IndexEntry*)calloc(capacity, sizeof(IndexEntry));
+    if(index->slots == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
     }
-    Node* curr = head;
-    while(curr->next != head) {
-        curr = curr->next;
+    index->capacity = capacity;
+    index->shift = indexShift(capacity);
+    index->used = 0;
+    index->filled = 0;
+    for(int i = 0; i < oldCapacity; i++) {
+        if(old[i].state == INDEX_USED)
+            indexAdd(index, old[i].key, old[i].prev);
+    }
+    free(old);
+}
+
+/*
+ * indexAdd: Adds an entry mapping key to the predecessor of its node.
+ * Explanation: Linear probing; the table grows when used and deleted slots exceed 70%.
+ */
+void indexAdd(ValueIndex* index, int key, Node* prev) {
+    if((index->filled + 1) * 10 > index->capacity * 7) {
+        // Grow only if live entries need it; otherwise just clear the tombstones.
+        indexResize(index, (index->used + 1) * 10 > index->capacity * 5 ? index->capacity * 2 : index->capacity);
+    }
+    unsigned int mask = (unsigned int)index->capacity - 1;
+    unsigned int i = hashKey(key, index->shift);
+    while(index->slots[i].state == INDEX_USED)
+        i = (i + 1) & mask;
+    if(index->slots[i].state == INDEX_EMPTY)
+        index->filled++;
+    index->slots[i].key = key;
+    index->slots[i].state = INDEX_USED;
+    index->slots[i].prev = prev;
+    index->used++;
+}
+
+/*
+ * indexFind: Returns the slot of an entry for key, or NULL if there is none.
+ * Explanation: When prev is NULL any entry with the key matches; otherwise the entry must also
+ * have that predecessor, which singles out one node among duplicates.
+ */
+IndexEntry* indexFind(ValueIndex* index, int key, Node* prev) {
+    unsigned int mask = (unsigned int)index->capacity - 1;
+    unsigned int i = hashKey(key, index->shift);
+    while(index->slots[i].state != INDEX_EMPTY) {
+        IndexEntry* entry = &index->slots[i];
+        if(entry->state == INDEX_USED && entry->key == key && (prev == NULL || entry->prev == prev))
+            return entry;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/*
+ * indexMove: Records that the node holding key now follows newPrev instead of oldPrev.
+ */
+void indexMove(ValueIndex* index, int key, Node* oldPrev, Node* newPrev) {
+    IndexEntry* entry = indexFind(index, key, oldPrev);
+    if(entry != NULL)
+        entry->prev = newPrev;
+}
+
+/*
+ * indexRemove: Removes the entry of the node holding key that follows prev.
+ */
+void indexRemove(ValueIndex* index, int key, Node* prev) {
+    IndexEntry* entry = indexFind(index, key, prev);
+    if(entry != NULL) {
+        entry->state = INDEX_DELETED;
+        index->used--;
     }
-    curr->next = newNode;  // Last node now points to the new node.
-    newNode->next = head;  // New node points back to head.
-    return head;           // Head remains unchanged.
+}
+
+/*
+ * initList: Initializes an empty circular list.
+ * Explanation: When useIndex is nonzero, the list maintains a value index so that searchNode,
+ * deleteNode and insertAfter do not have to scan the ring.
+ */
+void initList(CircularList* list, int useIndex) {
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+    list->index = useIndex ? createIndex(16) : NULL;
+}
+
+/*
+ * linkAfter: Links newNode right after prev (or as the only node when the list is empty).
+ * Explanation: Besides the two next pointers, two index entries change: the new node's
+ * predecessor is prev, and the node that used to follow prev is now preceded by newNode.
+ */
+void linkAfter(CircularList* list, Node* prev, Node* newNode) {
+    if(prev == NULL) {
+        // List is empty: the new node points to itself.
+        list->head = list->tail = newNode;
+        if(list->index)
+            indexAdd(list->index, newNode->data, newNode);
+    } else {
+        Node* following = prev->next;
+        newNode->next = following;
+        prev->next = newNode;
+        if(list->index) {
+            indexMove(list->index, following->data, prev, newNode);
+            indexAdd(list->index, newNode->data, prev);
+        }
+        if(prev == list->tail)
+            list->tail = newNode;
+    }
+    list->count++;
+}
+
+/*
+ * findPredecessor: Returns the node before a node holding key, or NULL if not found.
+ * Explanation: Without the index the ring is scanned starting at the head, whose predecessor is
+ * the tail, so the first node holding key is found. With the index enabled the lookup is a hash
+ * probe, and if several nodes hold key it may return the predecessor of any one of them.
+ */
+Node* findPredecessor(CircularList* list, int key) {
+    if(list->head == NULL)
+        return NULL;
+    if(list->index) {
+        IndexEntry* entry = indexFind(list->index, key, NULL);
+        return entry ? entry->prev : NULL;
+    }
+    Node* prev = list->tail;
+    do {
+        if(prev->next->data == key)
+            return prev;
+        prev = prev->next;
+    } while(prev != list->tail);
+    return NULL;
+}
+
+/*
+ * insertAtBeginning: Inserts a new node at the beginning of the circular linked list.
+ * Explanation: The new node is linked after the last node and becomes the new head.
+ * The tail pointer makes this O(1) instead of a walk around the ring.
+ */
+void insertAtBeginning(CircularList* list, int data) {
+    Node* newNode = createNode(data);
+    Node* last = list->tail;
+    linkAfter(list, last, newNode);  // Last node now points to the new node.
+    list->head = newNode;            // New node is the new head.
+    if(last != NULL)
+        list->tail = last;           // The last node stays the tail.
+}
+
+/*
+ * insertAtEnd: Inserts a new node at the end of the circular linked list.
+ * Explanation: The new node is linked after the tail and becomes the new tail; head remains unchanged.
+ */
+void insertAtEnd(CircularList* list, int data) {
+    Node* newNode = createNode(data);
+    linkAfter(list, list->tail, newNode);
 }
 
 /*
  * insertAfter: Inserts a new node after the node containing a specific target value.
- * Explanation: The function searches for the target value in the list. If found,
- * it inserts the new node right after the target node. If the target is not found,
- * the list remains unchanged.
+ * Explanation: The function finds the target node (through the index when enabled). If found,
+ * it inserts the new node right after it. If the target is not found, the list remains unchanged.
  */
-Node* insertAfter(Node* head, int target, int data) {
-    if(head == NULL) {
+void insertAfter(CircularList* list, int target, int data) {
+    if(list->head == NULL) {
         printf("List is empty.\n");
-        return head;
+        return;
     }
-    Node* curr = head;
-    do {
-        if(curr->data == target) {
-            Node* newNode = createNode(data);
-            newNode->next = curr->next;
-            curr->next = newNode;
-            return head;
-        }
+    Node* prev = findPredecessor(list, target);
+    if(prev == NULL) {
+        printf("Element %d not found in the list.\n", target);
+        return;
+    }
+    linkAfter(list, prev->next, createNode(data));
+}
+
+/*
+ * buildFromArray: Appends the values of an array to the circular list in one pass.
+ * Explanation: The new nodes are linked to each other as they are created and the ring is
+ * closed once at the end, instead of going through linkAfter for every value. With
+ * USE_NODE_POOL they are one contiguous block of the pool. When the index is enabled, every
+ * new node gets its entry and the head's entry moves from the old tail to the new one.
+ */
+void buildFromArray(CircularList* list, const int* values, int count) {
+    if(count <= 0)
+        return;
+#ifdef USE_NODE_POOL
+    char* block = (char*)poolAllocBlock(&nodePool, count);
+#endif
+    Node dummy;
+    Node* last = &dummy;
+    for(int i = 0; i < count; i++) {
+#ifdef USE_NODE_POOL
+        Node* newNode = (Node*)(block + (size_t)i * nodePool.nodeSize);
+        newNode->data = values[i];
+#else
+        Node* newNode = createNode(values[i]);
+#endif
+        if(list->index && last != &dummy)
+            indexAdd(list->index, newNode->data, last);
+        last->next = newNode;
+        last = newNode;
+    }
+    Node* first = dummy.next;
+    Node* firstPrev;             // Node that will precede the first new node.
+    if(list->head == NULL) {
+        list->head = first;
+        firstPrev = last;        // The new nodes form the whole ring.
+    } else {
+        list->tail->next = first;
+        if(list->index)
+            indexMove(list->index, list->head->data, list->tail, last);
+        firstPrev = list->tail;
+    }
+    if(list->index)
+        indexAdd(list->index, first->data, firstPrev);
+    last->next = list->head;     // Close the ring.
+    list->tail = last;
+    list->count += count;
+}
+
+/*
+ * saveList: Writes the values of the list, starting at the head, to a file.
+ * Explanation: Uses the flat format of listFile.h. Returns 0 on success and -1 on failure.
+ */
+int saveList(CircularList* list, const char* path) {
+    ListFileWriter writer;
+    if(listFileCreate(&writer, path, (uint64_t)list->count) != 0)
+        return -1;
+    Node* curr = list->head;
+    for(int i = 0; i < list->count; i++) {
+        listFilePut(&writer, curr->data);
         curr = curr->next;
-    } while(curr != head);
-    printf("Element %d not found in the list.\n", target);
-    return head;
+    }
+    return listFileClose(&writer);
+}
+
+/*
+ * loadList: Appends the values of a file written by saveList to the list.
+ * Explanation: The file is mapped with mmap and its values are read in place by
+ * buildFromArray, so the list is rebuilt in one pass. Returns 0 on success and -1 on failure.
+ */
+int loadList(CircularList* list, const char* path) {
+    ListFileMapping file;
+    if(listFileMap(&file, path) != 0)
+        return -1;
+    if(file.count > (uint64_t)(INT_MAX - list->count)) {
+        printf("%s holds too many values for one list.\n", path);
+        listFileUnmap(&file);
+        return -1;
+    }
+    buildFromArray(list, file.values, (int)file.count);
+    listFileUnmap(&file);
+    return 0;
 }
 
 /*
  * displayList: Prints all the elements of the circular linked list.
  * Explanation: The function starts from the head and traverses the list until it comes back to the head.
  */
-void displayList(Node* head) {
-    if(head == NULL) {
+void displayList(CircularList* list) {
+    if(list->head == NULL) {
         printf("List is empty.\n");
         return;
     }
-    Node* curr = head;
+    Node* curr = list->head;
     printf("Circular Linked List: ");
     do {
         printf("%d ", curr->data);
         curr = curr->next;
-    } while(curr != head);
+    } while(curr != list->head);
     printf("\n");
 }
 
 /*
  * searchNode: Searches for a node with the specified key in the circular linked list.
- * Explanation: This function traverses the list from head to head again and returns a pointer
- * to the node if the key is found; otherwise, it returns NULL.
+ * Explanation: Returns a pointer to the node if the key is found; otherwise, it returns NULL.
+ * With the index enabled this is an expected O(1) hash lookup instead of a scan.
  */
-Node* searchNode(Node* head, int key) {
-    if(head == NULL)
-        return NULL;
-    Node* curr = head;
-    do {
-        if(curr->data == key)
-            return curr;
-        curr = curr->next;
-    } while(curr != head);
-    return NULL;
+Node* searchNode(CircularList* list, int key) {
+    Node* prev = findPredecessor(list, key);
+    return prev ? prev->next : NULL;
 }
 
 /*
- * deleteNode: Deletes the first node with the specified key from the circular linked list.
- * Explanation: The function handles the deletion of the head node and any other node.
- * For the head deletion, it finds the last node to update its next pointer.
+ * deleteNode: Deletes a node with the specified key from the circular linked list.
+ * Explanation: The predecessor of the node is found (through the index when enabled) and
+ * linked past it. Head and tail are moved if they were the deleted node.
  * If the key is not found, the list remains unchanged.
  */
-Node* deleteNode(Node* head, int key) {
-    if(head == NULL) {
+void deleteNode(CircularList* list, int key) {
+    if(list->head == NULL) {
         printf("List is empty.\n");
-        return NULL;
+        return;
     }
-    
-    Node *curr = head, *prev = NULL;
-    
-    // Check if head node is to be deleted.
-    if(head->data == key) {
-        // If there is only one node in the list.
-        if(head->next == head) {
-            free(head);
-            return NULL;
-        }
-        // Find the last node to update its next pointer.
-        Node* last = head;
-        while(last->next != head)
-            last = last->next;
-        last->next = head->next;
-        Node* temp = head->next;
-        free(head);
-        return temp;  // New head is the next node.
+    Node* prev = findPredecessor(list, key);
+    if(prev == NULL) {
+        printf("Element %d not found in the list.\n", key);
+        return;
     }
-    
-    // Traverse the list to find the node to delete.
-    prev = head;
-    curr = head->next;
-    while(curr != head) {
-        if(curr->data == key) {
-            prev->next = curr->next;
-            free(curr);
-            return head;
+    Node* curr = prev->next;
+    if(list->index)
+        indexRemove(list->index, key, prev);
+    if(curr == prev) {
+        // It was the only node in the list.
+        list->head = list->tail = NULL;
+    } else {
+        Node* following = curr->next;
+        prev->next = following;
+        if(list->index)
+            indexMove(list->index, following->data, curr, prev);
+        if(curr == list->head)
+            list->head = following;  // New head is the next node.
+        if(curr == list->tail)
+            list->tail = prev;
+    }
+    freeNode(curr);
+    list->count--;
+}
+
+/*
+ * countNodes: Returns the number of nodes in the circular linked list.
+ * Explanation: The count is maintained by every insertion and deletion, so no traversal is needed.
+ */
+int countNodes(CircularList* list) {
+    return list->count;
+}
+
+/*
+ * freeList: Releases every node of the circular linked list and its index.
+ * Explanation: The ring is broken after the last node, then the nodes are freed one by one.
+ */
+void freeList(CircularList* list) {
+    if(list->head != NULL) {
+        Node* curr = list->head;
+        list->tail->next = NULL; // Break the ring so the walk ends.
+        while(curr != NULL) {
+            Node* next = curr->next;
+            freeNode(curr);
+            curr = next;
         }
-        prev = curr;
-        curr = curr->next;
     }
-    printf("Element %d not found in the list.\n", key);
-    return head;
+    freeIndex(list->index);
+    list->head = list->tail = NULL;
+    list->count = 0;
+    list->index = NULL;
 }
 
 /*
- * countNodes: Counts the number of nodes in the circular linked list.
- * Explanation: The function traverses the list starting from the head until it loops back,
- * incrementing a counter for each node.
+ * nowSeconds: Returns a monotonic timestamp in seconds.
  */
-int countNodes(Node* head) {
-    if(head == NULL)
-        return 0;
-    int count = 0;
-    Node* curr = head;
-    do {
-        count++;
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * sumList: Returns the sum of all values, used to check a restored list.
+ */
+long long sumList(CircularList* list) {
+    long long sum = 0;
+    Node* curr = list->head;
+    for(int i = 0; i < list->count; i++) {
+        sum += curr->data;
         curr = curr->next;
-    } while(curr != head);
-    return count;
+    }
+    return sum;
+}
+
+/*
+ * benchmarkSaveLoad: Times saving a list of n elements and restoring it in two ways.
+ * Explanation: The node-by-node restore reads the file with fread and calls insertAtEnd for
+ * every value; loadList maps the file and builds the ring in one pass. The list has no index.
+ */
+void benchmarkSaveLoad(int n, const char* path) {
+    CircularList list;
+    initList(&list, 0);
+    unsigned int seed = 12345;
+    for(int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        insertAtEnd(&list, (int)(seed >> 8));
+    }
+    long long expected = sumList(&list);
+    double megabytes = (sizeof(ListFileHeader) + (double)n * sizeof(int)) / 1e6;
+
+    double start = nowSeconds();
+    if(saveList(&list, path) != 0) {
+        freeList(&list);
+        remove(path);
+        return;
+    }
+    double elapsed = nowSeconds() - start;
+    printf("save            : %8.1f ms  %7.1f M elements/s  %7.1f MB/s\n",
+           elapsed * 1e3, n / elapsed / 1e6, megabytes / elapsed);
+    freeList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool); // Both restores start from an empty pool.
+#endif
+
+    // Restore node by node.
+    initList(&list, 0);
+    start = nowSeconds();
+    FILE* file = fopen(path, "rb");
+    ListFileHeader header;
+    int buffer[LIST_FILE_BUFFER];
+    size_t got;
+    if(file == NULL || fread(&header, sizeof(header), 1, file) != 1) {
+        printf("Cannot read %s.\n", path);
+        if(file != NULL)
+            fclose(file);
+        remove(path);
+        return;
+    }
+    while((got = fread(buffer, sizeof(int), LIST_FILE_BUFFER, file)) > 0) {
+        for(size_t i = 0; i < got; i++)
+            insertAtEnd(&list, buffer[i]);
+    }
+    fclose(file);
+    elapsed = nowSeconds() - start;
+    printf("insertAtEnd load: %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    freeList(&list);
+#ifdef USE_NODE_POOL
+    poolReleaseAll(&nodePool);
+#endif
+
+    // Restore with loadList.
+    initList(&list, 0);
+    start = nowSeconds();
+    if(loadList(&list, path) != 0) {
+        freeList(&list);
+        remove(path);
+        return;
+    }
+    elapsed = nowSeconds() - start;
+    printf("mmap load       : %8.1f ms  %7.1f M elements/s  (%s)\n",
+           elapsed * 1e3, n / elapsed / 1e6, sumList(&list) == expected ? "ok" : "MISMATCH");
+    freeList(&list);
+    remove(path);
 }
 
 /*
@@ -197,39 +599,66 @@ int countNodes(Node* head) {
  *   - Searching for a node.
  *   - Counting the nodes.
  *   - Deleting a node.
+ *   - Saving the list to a file and loading it back.
+ * Usage: ./circularLinkedList [benchmarkElements] also benchmarks saving and restoring a list
+ * of that many elements (e.g. 100000000).
  */
-int main() {
-    Node* head = NULL;
+int main(int argc, char* argv[]) {
+    CircularList list;
+    initList(&list, 1); // Keep a value index for search, delete and insertAfter.
     
     // Insert elements at the end.
-    head = insertAtEnd(head, 10);
-    head = insertAtEnd(head, 20);
-    head = insertAtEnd(head, 30);
-    displayList(head);
+    insertAtEnd(&list, 10);
+    insertAtEnd(&list, 20);
+    insertAtEnd(&list, 30);
+    displayList(&list);
     
     // Insert an element at the beginning.
-    head = insertAtBeginning(head, 5);
-    displayList(head);
+    insertAtBeginning(&list, 5);
+    displayList(&list);
     
     // Insert an element after a specific node.
-    head = insertAfter(head, 20, 25);
-    displayList(head);
+    insertAfter(&list, 20, 25);
+    displayList(&list);
     
     // Search for an element.
     int key = 25;
-    Node* found = searchNode(head, key);
+    Node* found = searchNode(&list, key);
     if(found)
         printf("Element %d found in the list.\n", key);
     else
         printf("Element %d not found in the list.\n", key);
     
     // Count the number of nodes.
-    printf("Total nodes in the list: %d\n", countNodes(head));
+    printf("Total nodes in the list: %d\n", countNodes(&list));
     
     // Delete a node.
-    head = deleteNode(head, 30);
-    displayList(head);
+    deleteNode(&list, 30);
+    displayList(&list);
     
+    // Save the list and load it into a second list that also keeps an index.
+    CircularList copy;
+    initList(&copy, 1);
+    if(saveList(&list, "list.bin") == 0 && loadList(&copy, "list.bin") == 0) {
+        printf("Loaded from list.bin: ");
+        displayList(&copy);
+        printf("Element 25 found in the loaded list: %s\n", searchNode(&copy, 25) ? "yes" : "no");
+    }
+    remove("list.bin");
+    freeList(&copy);
+    freeList(&list);
+
+    if(argc > 1) {
+        int n = atoi(argv[1]);
+        if(n <= 0) {
+            printf("Usage: %s [benchmarkElements]\n", argv[0]);
+            return 1;
+        }
+        printf("\nSave/restore of %d elements:\n", n);
+        benchmarkSaveLoad(n, "list-benchmark.bin");
+    }
+#ifdef USE_NODE_POOL
+    poolDestroy(&nodePool); // Release the pool's slabs in one call.
+#endif
     return 0;
 }
-
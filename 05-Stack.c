@@ -1,102 +1,117 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "genericStack.h"
 
-#define MAX 100  // Maximum capacity of the stack
-
-// Define the Stack structure using an array.
-typedef struct {
-    int items[MAX]; // Array to store stack elements.
-    int top;        // Index of the top element in the stack.
-} Stack;
+#define STACK_INLINE_CAPACITY 16  // Elements stored inside the Stack itself before it moves to the heap.
+#define MAX 100                   // Capacity of the fixed array stack used as the benchmark baseline.
 
 /*
- * initStack: Initializes the stack.
- * Explanation: This function sets the top index to -1, indicating that the stack is empty.
+ * Stack: A growable stack of ints generated by genericStack.h.
+ * Explanation: Shallow stacks keep their elements in an inline buffer and never touch the heap;
+ * once that buffer is full, the elements move to a heap block that doubles whenever it runs out
+ * of room. This defines the Stack type and initStack, freeStack, reserve, shrinkToFit, isEmpty,
+ * isFull, size, push, pop, peek, pushMany and popMany. A Stack must not be copied by value.
  */
-void initStack(Stack *s) {
-    s->top = -1;
-}
+DEFINE_STACK(Stack, int, , STACK_INLINE_CAPACITY)
 
 /*
- * isEmpty: Checks if the stack is empty.
- * Explanation: Returns 1 (true) if the stack is empty, otherwise returns 0 (false).
+ * printStack: Prints all elements in the stack from top to bottom.
+ * Explanation: This function iterates from the top element down to the bottom of the stack and prints each element.
  */
-int isEmpty(Stack *s) {
-    return s->top == -1;
+void printStack(Stack *s) {
+    if (isEmpty(s)) {
+        printf("Stack is empty.\n");
+        return;
+    }
+    printf("Stack elements (top to bottom): ");
+    for (int i = s->top; i >= 0; i--) {
+        printf("%d ", s->items[i]);
+    }
+    printf("\n");
 }
 
-/*
- * isFull: Checks if the stack is full.
- * Explanation: Returns 1 (true) if the stack has reached its maximum capacity, otherwise returns 0 (false).
- */
-int isFull(Stack *s) {
-    return s->top == MAX - 1;
-}
+// Fixed array stack as it was before the stack could grow, kept as the benchmark baseline.
+typedef struct {
+    int items[MAX];  // Array to store stack elements.
+    int top;         // Index of the top element in the stack.
+} FixedStack;
 
 /*
- * push: Pushes an element onto the stack.
- * Explanation: This function adds a new element to the top of the stack. It first checks if the stack is full.
+ * fixedPush / fixedPop: push and pop of the fixed array stack, with the same checks as before.
  */
-void push(Stack *s, int value) {
-    if (isFull(s)) {
+void fixedPush(FixedStack *s, int value) {
+    if (s->top == MAX - 1) {
         printf("Stack Overflow. Cannot push %d\n", value);
         return;
     }
     s->items[++(s->top)] = value;
 }
 
-/*
- * pop: Removes the top element from the stack and returns it.
- * Explanation: This function first checks if the stack is empty. If not, it returns the top element and decrements the top index.
- */
-int pop(Stack *s) {
-    if (isEmpty(s)) {
+int fixedPop(FixedStack *s) {
+    if (s->top == -1) {
         printf("Stack Underflow. Cannot pop from an empty stack.\n");
-        exit(1); // Terminate the program in case of underflow.
+        exit(1);
     }
     return s->items[(s->top)--];
 }
 
 /*
- * peek: Returns the top element of the stack without removing it.
- * Explanation: This function checks if the stack is empty and then returns the top element.
+ * nowSeconds: Returns a monotonic timestamp in seconds.
  */
-int peek(Stack *s) {
-    if (isEmpty(s)) {
-        printf("Stack is empty. No top element.\n");
-        exit(1); // Terminate the program if the stack is empty.
-    }
-    return s->items[s->top];
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
 /*
- * size: Returns the number of elements in the stack.
- * Explanation: This function calculates the current size of the stack by adding one to the top index.
+ * benchmarkStacks: Compares push/pop throughput of the growable and the fixed array stack.
+ * Explanation: Each round pushes depth elements and pops them again. depth stays below MAX so the
+ * fixed stack never overflows; the growable stack has grown to that depth after the first round.
  */
-int size(Stack *s) {
-    return s->top + 1;
-}
-
-/*
- * printStack: Prints all elements in the stack from top to bottom.
- * Explanation: This function iterates from the top element down to the bottom of the stack and prints each element.
- */
-void printStack(Stack *s) {
-    if (isEmpty(s)) {
-        printf("Stack is empty.\n");
-        return;
+void benchmarkStacks(int rounds, int depth) {
+    FixedStack fixed;
+    fixed.top = -1;
+    long long fixedSum = 0;
+    double start = nowSeconds();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < depth; i++) {
+            fixedPush(&fixed, i + r);
+        }
+        for (int i = 0; i < depth; i++) {
+            fixedSum += fixedPop(&fixed);
+        }
     }
-    printf("Stack elements (top to bottom): ");
-    for (int i = s->top; i >= 0; i--) {
-        printf("%d ", s->items[i]);
+    double fixedTime = nowSeconds() - start;
+
+    Stack stack;
+    initStack(&stack);
+    long long sum = 0;
+    start = nowSeconds();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < depth; i++) {
+            push(&stack, i + r);
+        }
+        for (int i = 0; i < depth; i++) {
+            sum += pop(&stack);
+        }
     }
-    printf("\n");
+    double growableTime = nowSeconds() - start;
+    freeStack(&stack);
+
+    double operations = 2.0 * rounds * depth;
+    printf("Push/pop benchmark, %d rounds of depth %d:\n", rounds, depth);
+    printf("  fixed array : %7.2f ms  %6.1f M ops/s\n", fixedTime * 1e3, operations / fixedTime / 1e6);
+    printf("  growable    : %7.2f ms  %6.1f M ops/s  (%s)\n", growableTime * 1e3,
+           operations / growableTime / 1e6, sum == fixedSum ? "same results" : "MISMATCH");
 }
 
 /*
  * main: Demonstrates the stack operations.
  * Explanation: This function creates a stack, performs several operations (push, pop, peek, size, and printStack),
- * and prints the results.
+ * grows it past its inline buffer with bulk operations, and prints the results.
  */
 int main() {
     Stack stack;
@@ -122,5 +137,24 @@ int main() {
     // Print the stack after pop operation.
     printStack(&stack);
     
+    // Push a whole array at once; the stack outgrows its inline buffer and moves to the heap.
+    int values[1000];
+    for (int i = 0; i < 1000; i++) {
+        values[i] = i;
+    }
+    pushMany(&stack, values, 1000);
+    printf("After pushing 1000 elements: size %d, capacity %d, on heap: %s\n",
+           size(&stack), stack.capacity, stack.items != stack.inlineItems ? "yes" : "no");
+    
+    // Pop most of them back and give the unused memory back.
+    int popped = popMany(&stack, values, 995);
+    shrinkToFit(&stack);
+    printf("After popping %d elements and shrinkToFit: size %d, capacity %d, on heap: %s\n",
+           popped, size(&stack), stack.capacity, stack.items != stack.inlineItems ? "yes" : "no");
+    printStack(&stack);
+    freeStack(&stack);
+    
+    printf("\n");
+    benchmarkStacks(2000000, 64);
     return 0;
 }
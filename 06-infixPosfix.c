@@ -1,135 +1,263 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "genericStack.h"
 
-#define MAX 100
+#define STACK_INLINE_CAPACITY 64  // Stack elements kept inline before a stack moves to the heap.
+#define READ_CHUNK 65536          // Bytes a file reader reads at a time.
+#define MAP_WINDOW (4 << 20)      // Bytes of a mapped file a reader walks before dropping them.
+#define MAX_TOKEN 63              // Longest number literal, in characters.
+#define MAX_NAME 31               // Longest variable name.
+
+// Set by the batch mode, which reports an invalid line as "error" in its output instead.
+static int quietErrors = 0;
 
 /*
- * CharStack structure and its operations:
- * This stack is used to hold operators during infix to postfix conversion.
+ * CharStack and DoubleStack: Stacks generated by genericStack.h.
+ * Explanation: CharStack holds operators during infix to postfix conversion and DoubleStack holds
+ * operands during evaluation. Both keep up to STACK_INLINE_CAPACITY elements inline and grow on
+ * the heap beyond that, so deeply nested expressions never overflow. This defines
+ * initCharStack, freeCharStack, isEmptyChar, pushChar, popChar, peekChar (and the same for Double).
+ * Popping or peeking an empty stack prints "Stack underflow" and exits.
  */
-typedef struct {
-    char items[MAX];
-    int top;
-} CharStack;
+DEFINE_STACK(CharStack, char, Char, STACK_INLINE_CAPACITY)
+DEFINE_STACK(DoubleStack, double, Double, STACK_INLINE_CAPACITY)
 
 /*
- * initCharStack: Initializes the character stack.
- * Explanation: This function sets the top index of the stack to -1, indicating an empty stack.
+ * Tokens
+ * Explanation: Expressions are read as a stream of tokens, so nothing limits their length:
+ *   - numbers: integer and floating-point literals such as 42, 3.75 or .5;
+ *   - names: variables, a letter followed by letters, digits or '_';
+ *   - operators: + - * / ^, and ~ for negation (a '-' with no left operand is read as ~ too);
+ *   - parentheses.
+ * Whitespace (including newlines) separates tokens and is otherwise ignored.
  */
-void initCharStack(CharStack *s) {
-    s->top = -1;
-}
+typedef enum { TOKEN_NUMBER, TOKEN_NAME, TOKEN_OPERATOR, TOKEN_LEFT, TOKEN_RIGHT, TOKEN_END, TOKEN_ERROR } TokenType;
+
+typedef struct {
+    TokenType type;
+    char op;                    // Operator character for TOKEN_OPERATOR.
+    double value;               // Value of a TOKEN_NUMBER.
+    char text[MAX_TOKEN + 1];   // Source text of a number, name or operator.
+    long long position;         // Offset of the token in the input, for error messages.
+} Token;
 
 /*
- * isEmptyChar: Checks if the character stack is empty.
- * Explanation: Returns 1 (true) if the stack is empty, 0 (false) otherwise.
+ * TokenReader: Where tokens come from.
+ * Explanation: A reader walks one block of characters (data, length). For a string that block is
+ * the whole input. A file reader refills buffer with READ_CHUNK bytes at a time, and a mapped file
+ * is walked in windows of MAP_WINDOW bytes, so neither uses memory in proportion to the size of
+ * the file. Tokens may span two blocks.
  */
-int isEmptyChar(CharStack *s) {
-    return s->top == -1;
-}
+typedef struct {
+    const char* data;           // Block being read.
+    size_t length;              // Bytes in the block.
+    size_t pos;                 // Next byte of the block.
+    long long consumed;         // Bytes of earlier blocks.
+    FILE* file;                 // File that refills the block, NULL for strings and mappings.
+    char* mapping;              // Mapped file, NULL if nothing is mapped.
+    size_t mappingLength;       // Length of the mapping.
+    char* buffer;               // READ_CHUNK bytes for a file reader.
+} TokenReader;
 
 /*
- * pushChar: Pushes a character onto the stack.
- * Explanation: This function adds an element to the top of the stack, and exits if the stack is full.
+ * initStringReader / initFileReader: Read tokens from a string or from an open file.
  */
-void pushChar(CharStack *s, char c) {
-    if(s->top == MAX - 1) {
-        printf("Stack overflow\n");
-        exit(1);
-    }
-    s->items[++(s->top)] = c;
+void initStringReader(TokenReader *r, const char *text, size_t length) {
+    memset(r, 0, sizeof(*r));
+    r->data = text;
+    r->length = length;
 }
 
-/*
- * popChar: Pops a character from the stack.
- * Explanation: This function removes and returns the top element of the stack. If the stack is empty, it exits.
- */
-char popChar(CharStack *s) {
-    if(isEmptyChar(s)) {
-        printf("Stack underflow\n");
+void initFileReader(TokenReader *r, FILE *file) {
+    memset(r, 0, sizeof(*r));
+    r->file = file;
+    r->buffer = (char*)malloc(READ_CHUNK);
+    if(r->buffer == NULL) {
+        printf("Memory allocation failed.\n");
         exit(1);
     }
-    return s->items[(s->top)--];
+    r->data = r->buffer;
 }
 
 /*
- * peekChar: Returns the top element of the stack without removing it.
- * Explanation: If the stack is empty, it returns a null character.
+ * mapFileReader: Reads tokens from a file mapped with mmap.
+ * Explanation: The kernel reads the file ahead as it is walked, and every window that has been
+ * read is dropped again with MADV_DONTNEED. Returns 0 on success, -1 on error.
  */
-char peekChar(CharStack *s) {
-    if(isEmptyChar(s)) {
-        return '\0';
+int mapFileReader(TokenReader *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        printf("Cannot open %s.\n", path);
+        return -1;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0) {
+        close(fd);
+        printf("Cannot open %s.\n", path);
+        return -1;
+    }
+    if(info.st_size > 0) {
+        void *mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            r->mapping = NULL;
+            close(fd);
+            printf("Cannot map %s.\n", path);
+            return -1;
+        }
+        madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+        r->mapping = (char*)mapping;
+        r->mappingLength = (size_t)info.st_size;
     }
-    return s->items[s->top];
+    close(fd);
+    r->data = r->mapping;
+    r->length = r->mappingLength < MAP_WINDOW ? r->mappingLength : MAP_WINDOW;
+    return 0;
 }
 
 /*
- * IntStack structure and its operations:
- * This stack is used to hold integer operands during postfix expression evaluation.
+ * closeReader: Releases the buffer or mapping of a reader. The file itself is left open.
  */
-typedef struct {
-    int items[MAX];
-    int top;
-} IntStack;
+void closeReader(TokenReader *r) {
+    free(r->buffer);
+    if(r->mapping != NULL)
+        munmap(r->mapping, r->mappingLength);
+    memset(r, 0, sizeof(*r));
+}
 
 /*
- * initIntStack: Initializes the integer stack.
- * Explanation: Sets the top index to -1, indicating an empty stack.
+ * peekByte / nextByte: Look at or consume the next input character; EOF at the end of the input.
  */
-void initIntStack(IntStack *s) {
-    s->top = -1;
+static int refillReader(TokenReader *r) {
+    if(r->file == NULL && r->mapping == NULL)
+        return 0;
+    r->consumed += (long long)r->length;
+    r->pos = 0;
+    if(r->file != NULL) {
+        r->length = fread(r->buffer, 1, READ_CHUNK, r->file);
+    } else {
+        madvise((void*)r->data, r->length, MADV_DONTNEED);  // This window has been read.
+        r->data += r->length;
+        size_t left = r->mappingLength - (size_t)r->consumed;
+        r->length = left < MAP_WINDOW ? left : MAP_WINDOW;
+    }
+    return r->length > 0;
 }
 
-/*
- * isEmptyInt: Checks if the integer stack is empty.
- * Explanation: Returns 1 (true) if the stack is empty, 0 (false) otherwise.
- */
-int isEmptyInt(IntStack *s) {
-    return s->top == -1;
+static inline int peekByte(TokenReader *r) {
+    if(r->pos == r->length && !refillReader(r))
+        return EOF;
+    return (unsigned char)r->data[r->pos];
 }
 
-/*
- * pushInt: Pushes an integer onto the stack.
- * Explanation: This function adds an integer to the top of the stack, and exits if the stack is full.
- */
-void pushInt(IntStack *s, int val) {
-    if(s->top == MAX - 1) {
-        printf("Stack overflow\n");
-        exit(1);
-    }
-    s->items[++(s->top)] = val;
+static inline int nextByte(TokenReader *r) {
+    int c = peekByte(r);
+    if(c != EOF)
+        r->pos++;
+    return c;
 }
 
 /*
- * popInt: Pops an integer from the stack.
- * Explanation: This function removes and returns the top integer from the stack. If the stack is empty, it exits.
+ * isOperator: Checks whether a given character is an operator.
+ * Explanation: Returns 1 (true) if the character is one of '+', '-', '*', '/', '^' or '~' (negation); otherwise returns 0 (false).
  */
-int popInt(IntStack *s) {
-    if(isEmptyInt(s)) {
-        printf("Stack underflow\n");
-        exit(1);
-    }
-    return s->items[(s->top)--];
+int isOperator(char c) {
+    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '^' || c == '~');
 }
 
 /*
- * isOperator: Checks whether a given character is an operator.
- * Explanation: Returns 1 (true) if the character is one of '+', '-', '*', '/', or '^'; otherwise returns 0 (false).
+ * nextToken: Reads the next token into *t.
+ * Explanation: Returns the token type. At the end of the input the type is TOKEN_END; an unknown
+ * character or a literal that is too long or malformed gives TOKEN_ERROR with a message in t->text.
  */
-int isOperator(char c) {
-    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '^');
+TokenType nextToken(TokenReader *r, Token *t) {
+    int c = peekByte(r);
+    while(c != EOF && isspace(c)) {
+        r->pos++;
+        c = peekByte(r);
+    }
+    t->position = r->consumed + (long long)r->pos;
+    t->text[0] = '\0';
+    if(c == EOF)
+        return t->type = TOKEN_END;
+
+    int n = 0;
+    if(isdigit(c) || c == '.') {
+        // Number: digits with at most one decimal point.
+        int dots = 0;
+        while(c != EOF && (isdigit(c) || c == '.')) {
+            dots += c == '.';
+            if(n == MAX_TOKEN || dots > 1) {
+                strcpy(t->text, n == MAX_TOKEN ? "number too long" : "malformed number");
+                return t->type = TOKEN_ERROR;
+            }
+            t->text[n++] = (char)nextByte(r);
+            c = peekByte(r);
+        }
+        t->text[n] = '\0';
+        if(n == 1 && dots == 1) {
+            strcpy(t->text, "malformed number");
+            return t->type = TOKEN_ERROR;
+        }
+        if(dots == 0 && n <= 15) {
+            // Integers below 10^15 are exact in a double: skip strtod.
+            double value = 0;
+            for(int i = 0; i < n; i++)
+                value = value * 10 + (t->text[i] - '0');
+            t->value = value;
+        } else {
+            t->value = strtod(t->text, NULL);
+        }
+        return t->type = TOKEN_NUMBER;
+    }
+    if(isalpha(c)) {
+        while(c != EOF && (isalnum(c) || c == '_')) {
+            if(n == MAX_NAME) {
+                strcpy(t->text, "name too long");
+                return t->type = TOKEN_ERROR;
+            }
+            t->text[n++] = (char)nextByte(r);
+            c = peekByte(r);
+        }
+        t->text[n] = '\0';
+        return t->type = TOKEN_NAME;
+    }
+    nextByte(r);
+    t->text[0] = (char)c;
+    t->text[1] = '\0';
+    t->op = (char)c;
+    if(isOperator((char)c))
+        return t->type = TOKEN_OPERATOR;
+    if(c == '(')
+        return t->type = TOKEN_LEFT;
+    if(c == ')')
+        return t->type = TOKEN_RIGHT;
+    sprintf(t->text, "unexpected character '%c'", isprint(c) ? c : '?');
+    return t->type = TOKEN_ERROR;
 }
 
 /*
  * precedence: Returns the precedence of the given operator.
  * Explanation: Higher numerical values indicate higher precedence.
- *   '^' has the highest precedence, followed by '*' and '/' and finally '+' and '-'.
+ *   '^' has the highest precedence, then negation '~', then '*' and '/' and finally '+' and '-'.
+ *   So -2^2 is -(2^2) and -a*b is (-a)*b.
  */
 int precedence(char op) {
     if(op == '^')
+        return 4;
+    else if(op == '~')
         return 3;
     else if(op == '*' || op == '/')
         return 2;
@@ -140,117 +268,1643 @@ int precedence(char op) {
 }
 
 /*
- * infixToPostfix: Converts an infix expression to a postfix expression.
- * Explanation: This function uses the Shunting-yard algorithm. It iterates over each character:
- *   - If the character is an operand, it is added to the output.
- *   - If it is an opening parenthesis, it is pushed to the stack.
- *   - If it is a closing parenthesis, operators are popped until an opening parenthesis is found.
- *   - If it is an operator, operators with higher or equal precedence are popped from the stack before pushing the current operator.
- */
-void infixToPostfix(char *infix, char *postfix) {
-    CharStack s;
-    initCharStack(&s);
-    int i = 0, k = 0;
-    char ch;
-    
-    while(infix[i] != '\0') {
-        ch = infix[i];
-        
-        // If the character is an operand, add it directly to the postfix expression.
-        if(isalnum(ch)) {
-            postfix[k++] = ch;
-        }
-        // If the character is an opening parenthesis, push it onto the stack.
-        else if(ch == '(') {
-            pushChar(&s, ch);
-        }
-        // If the character is a closing parenthesis, pop until an opening parenthesis is encountered.
-        else if(ch == ')') {
-            while(!isEmptyChar(&s) && peekChar(&s) != '(') {
-                postfix[k++] = popChar(&s);
+ * TokenSink: Receives the postfix tokens produced by convertExpression, one at a time.
+ * Returns 0 to continue or -1 to stop the conversion (after printing why).
+ */
+typedef int (*TokenSink)(void *context, const Token *t);
+
+// emitOperator: Passes an operator from the stack on to the sink.
+static int emitOperator(TokenSink sink, void *context, char op, long long position) {
+    Token t;
+    t.type = TOKEN_OPERATOR;
+    t.op = op;
+    t.text[0] = op;
+    t.text[1] = '\0';
+    t.position = position;
+    return sink(context, &t);
+}
+
+/*
+ * convertExpression: Converts an infix expression to postfix as it is read.
+ * Explanation: This function uses the Shunting-yard algorithm on the tokens of r and hands every
+ * postfix token to sink as soon as it is known, so no part of the input or output is kept:
+ *   - An operand is emitted directly.
+ *   - An opening parenthesis is pushed to the stack.
+ *   - A closing parenthesis pops operators until the opening parenthesis is found.
+ *   - An operator pops operators with higher precedence (or equal, unless it is right-associative
+ *     like '^' and '~') before it is pushed.
+ * Only the operator stack grows, with the nesting of the expression rather than its length.
+ * The caller passes the stack, so a program converting many expressions can reuse one; it is left
+ * empty. The expression is checked as it goes (operands and operators must alternate, parentheses
+ * must match), so the postfix output is always well formed. Returns 0 on success; on an error a
+ * message with the input position is printed and -1 is returned.
+ */
+int convertExpression(TokenReader *r, CharStack *operators, TokenSink sink, void *context) {
+    Token t;
+    int expectOperand = 1;    // No left operand yet: a '-' here is a negation.
+    const char *error = NULL;
+    while(error == NULL) {
+        TokenType type = nextToken(r, &t);
+        if(type == TOKEN_ERROR) {
+            error = t.text;
+        } else if(type == TOKEN_NUMBER || type == TOKEN_NAME) {
+            if(!expectOperand)
+                error = "operator expected";
+            else if(sink(context, &t) != 0)
+                error = "";
+            expectOperand = 0;
+        } else if(type == TOKEN_LEFT) {
+            if(!expectOperand)
+                error = "operator expected";
+            pushChar(operators, '(');
+        } else if(type == TOKEN_RIGHT) {
+            if(expectOperand) {
+                error = "operand expected";
+                break;
+            }
+            while(!isEmptyChar(operators) && peekChar(operators) != '(') {
+                if(emitOperator(sink, context, popChar(operators), t.position) != 0)
+                    error = "";
+            }
+            if(isEmptyChar(operators))
+                error = "unmatched ')'";
+            else
+                popChar(operators); // Remove the '(' from the stack.
+        } else if(type == TOKEN_OPERATOR && expectOperand) {
+            // A prefix operator: '+' does nothing, '-' and '~' negate.
+            if(t.op == '-' || t.op == '~')
+                pushChar(operators, '~');
+            else if(t.op != '+')
+                error = "operand expected";
+        } else if(type == TOKEN_OPERATOR) {
+            if(t.op == '~') {
+                error = "operator expected";
+                break;
+            }
+            while(!isEmptyChar(operators) && peekChar(operators) != '(' &&
+                  ((precedence(t.op) < precedence(peekChar(operators))) ||
+                  (precedence(t.op) == precedence(peekChar(operators)) && t.op != '^'))) {
+                if(emitOperator(sink, context, popChar(operators), t.position) != 0)
+                    error = "";
+            }
+            pushChar(operators, t.op);
+            expectOperand = 1;
+        } else {
+            // End of input: pop any remaining operators.
+            if(expectOperand) {
+                error = "operand expected";
+                break;
             }
-            if(!isEmptyChar(&s) && peekChar(&s) == '(')
-                popChar(&s); // Remove the '(' from the stack.
-        }
-        // If the character is an operator.
-        else if(isOperator(ch)) {
-            while(!isEmptyChar(&s) && isOperator(peekChar(&s)) &&
-                  ((precedence(ch) < precedence(peekChar(&s))) ||
-                  (precedence(ch) == precedence(peekChar(&s)) && ch != '^'))) {
-                postfix[k++] = popChar(&s);
+            while(error == NULL && !isEmptyChar(operators)) {
+                char op = popChar(operators);
+                if(op == '(')
+                    error = "unmatched '('";
+                else if(emitOperator(sink, context, op, t.position) != 0)
+                    error = "";
             }
-            pushChar(&s, ch);
+            break;
         }
-        i++;
     }
-    
-    // Pop any remaining operators from the stack and append them to the postfix expression.
-    while(!isEmptyChar(&s)) {
-        postfix[k++] = popChar(&s);
+    operators->top = -1;
+    if(error != NULL) {
+        if(error[0] != '\0' && !quietErrors)
+            printf("Invalid expression at position %lld: %s\n", t.position, error);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * PostfixText: Collects postfix tokens, separated by spaces, in a string or writes them to a file.
+ */
+typedef struct {
+    FILE *file;                 // Output file, or NULL to collect into text.
+    char *text;                 // Collected postfix expression.
+    size_t length;
+    size_t capacity;
+} PostfixText;
+
+int writePostfixToken(void *context, const Token *t) {
+    PostfixText *out = (PostfixText*)context;
+    size_t n = strlen(t->text);
+    if(out->file != NULL) {
+        if(out->length++ > 0)
+            putc(' ', out->file);
+        fwrite(t->text, 1, n, out->file);
+        return 0;
     }
-    postfix[k] = '\0'; // Null-terminate the postfix expression.
+    if(out->length + n + 2 > out->capacity) {
+        out->capacity = (out->length + n + 2) * 2;
+        out->text = (char*)realloc(out->text, out->capacity);
+        if(out->text == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    if(out->length > 0)
+        out->text[out->length++] = ' ';
+    memcpy(out->text + out->length, t->text, n + 1);
+    out->length += n;
+    return 0;
+}
+
+/*
+ * infixToPostfix: Converts an infix expression to a postfix expression.
+ * Explanation: Returns the postfix expression as a new string with the tokens separated by
+ * spaces ("12 3.5 + ~"), or NULL if the expression is invalid. The caller frees the string.
+ */
+char *infixToPostfix(const char *infix) {
+    TokenReader r;
+    CharStack operators;
+    PostfixText out = { NULL, NULL, 0, 0 };
+    initStringReader(&r, infix, strlen(infix));
+    initCharStack(&operators);
+    int status = convertExpression(&r, &operators, writePostfixToken, &out);
+    freeCharStack(&operators);
+    if(status != 0) {
+        free(out.text);
+        return NULL;
+    }
+    return out.text;
+}
+
+/*
+ * evaluateToken: Feeds one postfix token to an evaluation running on a DoubleStack.
+ * Explanation: A number is pushed. An operator pops its operands (two, or one for '~'), applies
+ * the operation and pushes the result. A name has no value here and stops the evaluation.
+ */
+int evaluateToken(void *context, const Token *t) {
+    DoubleStack *s = (DoubleStack*)context;
+    if(t->type == TOKEN_NUMBER) {
+        pushDouble(s, t->value);
+        return 0;
+    }
+    if(t->type != TOKEN_OPERATOR) {
+        if(!quietErrors)
+            printf("Variable %s has no value; evaluate a compiled program instead.\n", t->text);
+        return -1;
+    }
+    if(t->op == '~') {
+        pushDouble(s, -popDouble(s));
+        return 0;
+    }
+    double op2 = popDouble(s);
+    double op1 = popDouble(s);
+    switch(t->op) {
+        case '+': pushDouble(s, op1 + op2); break;
+        case '-': pushDouble(s, op1 - op2); break;
+        case '*': pushDouble(s, op1 * op2); break;
+        case '/': pushDouble(s, op1 / op2); break;
+        case '^': pushDouble(s, pow(op1, op2)); break;
+    }
+    return 0;
 }
 
 /*
  * evaluatePostfix: Evaluates a postfix expression and returns the result.
- * Explanation: This function uses an integer stack to process the postfix expression.
+ * Explanation: This function uses a double stack to process the space-separated postfix expression.
  *   - When an operand is encountered, it is pushed onto the stack.
- *   - When an operator is encountered, the top two operands are popped, the operation is performed,
+ *   - When an operator is encountered, its operands are popped, the operation is performed,
  *     and the result is pushed back onto the stack.
  *   - At the end, the stack contains the final result.
- * Note: This implementation assumes that the operands are single-digit numbers.
- */
-int evaluatePostfix(char *postfix) {
-    IntStack s;
-    initIntStack(&s);
-    int i = 0;
-    char ch;
-    int op1, op2;
-    
-    while(postfix[i] != '\0') {
-        ch = postfix[i];
-        // If the character is a digit, convert it to an integer and push onto the stack.
-        if(isdigit(ch)) {
-            pushInt(&s, ch - '0');
-        }
-        // If the character is an operator, pop two operands, apply the operator, and push the result.
-        else if(isOperator(ch)) {
-            op2 = popInt(&s);
-            op1 = popInt(&s);
-            switch(ch) {
-                case '+': pushInt(&s, op1 + op2); break;
-                case '-': pushInt(&s, op1 - op2); break;
-                case '*': pushInt(&s, op1 * op2); break;
-                case '/': pushInt(&s, op1 / op2); break;
-                case '^': pushInt(&s, (int)pow(op1, op2)); break;
-            }
+ * An operator without enough operands prints "Stack underflow" and exits.
+ */
+double evaluatePostfix(const char *postfix) {
+    TokenReader r;
+    Token t;
+    DoubleStack s;
+    initStringReader(&r, postfix, strlen(postfix));
+    initDoubleStack(&s);
+    while(nextToken(&r, &t) != TOKEN_END) {
+        if(t.type == TOKEN_ERROR || t.type == TOKEN_LEFT || t.type == TOKEN_RIGHT) {
+            printf("Invalid postfix expression at position %lld\n", t.position);
+            exit(1);
         }
-        i++;
+        if(evaluateToken(&s, &t) != 0)
+            exit(1);
     }
     // The final result is the only remaining element on the stack.
-    return popInt(&s);
+    double result = popDouble(&s);
+    freeDoubleStack(&s);
+    return result;
+}
+
+/*
+ * evaluateExpression: Evaluates an infix expression straight from a reader.
+ * Explanation: convertExpression feeds its postfix output to evaluateToken, so the expression is
+ * never stored in any form: memory use depends only on its nesting, however long the input is.
+ * Returns 0 and stores the value in *result, or -1 if the expression is invalid.
+ */
+int evaluateExpression(TokenReader *r, double *result) {
+    CharStack operators;
+    DoubleStack values;
+    initCharStack(&operators);
+    initDoubleStack(&values);
+    int status = convertExpression(r, &operators, evaluateToken, &values);
+    if(status == 0)
+        *result = popDouble(&values);
+    freeCharStack(&operators);
+    freeDoubleStack(&values);
+    return status;
+}
+
+/*
+ * Compiled expressions
+ * Explanation: compileExpression parses an infix expression once and turns it into a Program: a
+ * flat array of stack-machine instructions with a table of constants and a table of variable
+ * names. Evaluating a Program involves no parsing, so one formula can be run over millions of
+ * rows. Names are variables whose values are supplied at evaluation time.
+ */
+
+#define MAX_VARIABLES 32   // Distinct variables one program may use.
+#define MAX_CONSTANTS (1 << 24) // Distinct constants one program may use (the width of arg).
+#define BATCH_BLOCK 256    // Rows evaluated together by evaluateBatch.
+
+// Stack-machine operations: CONST and VAR push a value, NEG negates the top value and the others
+// replace the top two by one.
+typedef enum { OP_CONST, OP_VAR, OP_NEG, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW } OpCode;
+
+/*
+ * operatorCode: Returns the operation of an operator character ('~' is OP_NEG).
+ */
+OpCode operatorCode(char op) {
+    switch(op) {
+        case '~': return OP_NEG;
+        case '+': return OP_ADD;
+        case '-': return OP_SUB;
+        case '*': return OP_MUL;
+        case '/': return OP_DIV;
+        default:  return OP_POW;
+    }
+}
+
+// One instruction, 4 bytes.
+typedef struct {
+    unsigned int op : 8;    // OpCode.
+    unsigned int arg : 24;  // Constant index for OP_CONST, variable index for OP_VAR.
+} Instruction;
+
+// A compiled expression.
+typedef struct {
+    Instruction* code;                          // Instructions in execution order.
+    int length;                                 // Number of instructions.
+    int capacity;                               // Allocated instructions.
+    double* constants;                          // Constant table, each value stored once.
+    int constantCount;
+    int constantCapacity;
+    int* constantSlots;                         // Hash of constants: index + 1, or 0 if empty.
+    int slotCapacity;                           // Power of two, at least twice constantCount.
+    int slotShift;                              // 64 - log2(slotCapacity), for constantHash.
+    char variables[MAX_VARIABLES][MAX_NAME + 1];// Variable names in order of first use.
+    int variableCount;
+    int maxDepth;                               // Deepest the value stack gets while running.
+} Program;
+
+/*
+ * initProgram / freeProgram: Set up an empty program and release one.
+ */
+void initProgram(Program *p) {
+    memset(p, 0, sizeof(*p));
+}
+
+void freeProgram(Program *p) {
+    free(p->code);
+    free(p->constants);
+    free(p->constantSlots);
+    initProgram(p);
+}
+
+/*
+ * emitInstruction: Appends one instruction, doubling the code array when it is full.
+ */
+void emitInstruction(Program *p, OpCode op, int arg) {
+    if(p->length == p->capacity) {
+        p->capacity = p->capacity ? p->capacity * 2 : 16;
+        p->code = (Instruction*)realloc(p->code, p->capacity * sizeof(Instruction));
+        if(p->code == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    p->code[p->length].op = (unsigned int)op;
+    p->code[p->length].arg = (unsigned int)arg;
+    p->length++;
+}
+
+/*
+ * constantBits: Returns the bit pattern of a double, which is what constants are deduplicated on
+ * (so 0.0 and -0.0 stay apart).
+ */
+static uint64_t constantBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/*
+ * constantHash: Spreads a bit pattern over the constant slots (Fibonacci hashing, top bits).
+ */
+static unsigned int constantHash(uint64_t bits, int shift) {
+    return (unsigned int)((bits * 11400714819323198485ull) >> shift);
+}
+
+/*
+ * growConstantSlots: Doubles the constant hash (16 slots at first) and re-inserts every constant.
+ */
+static void growConstantSlots(Program *p) {
+    free(p->constantSlots);
+    p->slotCapacity = p->slotCapacity ? p->slotCapacity * 2 : 16;
+    p->slotShift = p->slotShift ? p->slotShift - 1 : 60;
+    p->constantSlots = (int*)calloc(p->slotCapacity, sizeof(int));
+    if(p->constantSlots == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    unsigned int mask = (unsigned int)p->slotCapacity - 1;
+    for(int c = 0; c < p->constantCount; c++) {
+        unsigned int i = constantHash(constantBits(p->constants[c]), p->slotShift);
+        while(p->constantSlots[i] != 0)
+            i = (i + 1) & mask;
+        p->constantSlots[i] = c + 1;
+    }
+}
+
+/*
+ * addConstant: Returns the index of value in the constant table, adding it if it is new.
+ * Explanation: A hash on the bit pattern finds repeated constants in O(1), so compiling stays
+ * linear in the number of constants. Returns -1 when the table holds MAX_CONSTANTS values.
+ */
+int addConstant(Program *p, double value) {
+    if(2 * (p->constantCount + 1) > p->slotCapacity && p->constantCount < MAX_CONSTANTS)
+        growConstantSlots(p);
+    uint64_t bits = constantBits(value);
+    unsigned int mask = (unsigned int)p->slotCapacity - 1;
+    unsigned int i = constantHash(bits, p->slotShift);
+    for(; p->constantSlots[i] != 0; i = (i + 1) & mask) {
+        if(constantBits(p->constants[p->constantSlots[i] - 1]) == bits)
+            return p->constantSlots[i] - 1;
+    }
+    if(p->constantCount == MAX_CONSTANTS)
+        return -1;
+    if(p->constantCount == p->constantCapacity) {
+        p->constantCapacity = p->constantCapacity ? p->constantCapacity * 2 : 8;
+        p->constants = (double*)realloc(p->constants, p->constantCapacity * sizeof(double));
+        if(p->constants == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    p->constants[p->constantCount] = value;
+    p->constantSlots[i] = p->constantCount + 1;
+    return p->constantCount++;
+}
+
+/*
+ * variableIndex: Returns the index of the named variable in names, adding it if it is new.
+ * Returns -1 when names already holds MAX_VARIABLES variables or the name is too long.
+ */
+int variableIndex(char names[][MAX_NAME + 1], int *count, const char *name) {
+    for(int i = 0; i < *count; i++) {
+        if(strcmp(names[i], name) == 0)
+            return i;
+    }
+    if(*count == MAX_VARIABLES || strlen(name) > MAX_NAME)
+        return -1;
+    strcpy(names[*count], name);
+    return (*count)++;
+}
+
+// State of compileExpression while the postfix tokens come in.
+typedef struct {
+    Program *program;
+    int depth;                  // Values on the stack after the instructions so far.
+} Compiler;
+
+/*
+ * compileToken: Turns one postfix token into one instruction.
+ */
+int compileToken(void *context, const Token *t) {
+    Compiler *c = (Compiler*)context;
+    Program *p = c->program;
+    if(t->type == TOKEN_NUMBER || t->type == TOKEN_NAME) {
+        int number = t->type == TOKEN_NUMBER;
+        int index = number ? addConstant(p, t->value)
+                           : variableIndex(p->variables, &p->variableCount, t->text);
+        if(index < 0) {
+            if(!quietErrors)
+                printf("Too many %s in the expression.\n", number ? "constants" : "variables");
+            return -1;
+        }
+        emitInstruction(p, number ? OP_CONST : OP_VAR, index);
+        if(++c->depth > p->maxDepth)
+            p->maxDepth = c->depth;
+        return 0;
+    }
+    OpCode op = operatorCode(t->op);
+    emitInstruction(p, op, 0);
+    if(op != OP_NEG)
+        c->depth--;     // A binary operation replaces two values by one.
+    return 0;
+}
+
+/*
+ * compileExpression: Compiles an infix expression into a program.
+ * Explanation: convertExpression produces the postfix tokens and every one of them becomes one
+ * instruction. The compiler tracks the stack depth, which gives the evaluators their stack size.
+ * Returns 0 on success; on error it prints a message and returns -1 with p left empty.
+ */
+int compileExpression(const char *infix, Program *p) {
+    TokenReader r;
+    CharStack operators;
+    Compiler c = { p, 0 };
+    initProgram(p);
+    initStringReader(&r, infix, strlen(infix));
+    initCharStack(&operators);
+    int status = convertExpression(&r, &operators, compileToken, &c);
+    freeCharStack(&operators);
+    if(status != 0)
+        freeProgram(p);
+    return status;
+}
+
+/*
+ * printProgram: Prints the instructions of a program, one per line.
+ */
+void printProgram(const Program *p) {
+    static const char *names[] = { "CONST", "VAR", "NEG", "ADD", "SUB", "MUL", "DIV", "POW" };
+    for(int i = 0; i < p->length; i++) {
+        Instruction in = p->code[i];
+        if(in.op == OP_CONST)
+            printf("  %-5s %g\n", names[in.op], p->constants[in.arg]);
+        else if(in.op == OP_VAR)
+            printf("  %-5s %s\n", names[in.op], p->variables[in.arg]);
+        else
+            printf("  %s\n", names[in.op]);
+    }
+}
+
+/*
+ * applyOperator: Applies one binary operation to two values.
+ */
+static inline double applyOperator(int op, double x, double y) {
+    switch(op) {
+        case OP_ADD: return x + y;
+        case OP_SUB: return x - y;
+        case OP_MUL: return x * y;
+        case OP_DIV: return x / y;
+        default:     return pow(x, y);
+    }
+}
+
+/*
+ * evaluateProgram: Evaluates a program for one set of variable values.
+ * Explanation: values[v] is the value of variable v (in the order of p->variables). This is a
+ * plain stack machine: one dispatch per instruction and value.
+ */
+double evaluateProgram(const Program *p, const double *values) {
+    DoubleStack s;
+    initDoubleStack(&s);
+    reserveDouble(&s, p->maxDepth);
+    for(int i = 0; i < p->length; i++) {
+        Instruction in = p->code[i];
+        if(in.op == OP_CONST) {
+            pushDouble(&s, p->constants[in.arg]);
+        } else if(in.op == OP_VAR) {
+            pushDouble(&s, values[in.arg]);
+        } else if(in.op == OP_NEG) {
+            pushDouble(&s, -popDouble(&s));
+        } else {
+            double y = popDouble(&s);
+            double x = popDouble(&s);
+            pushDouble(&s, applyOperator(in.op, x, y));
+        }
+    }
+    double result = popDouble(&s);
+    freeDoubleStack(&s);
+    return result;
+}
+
+/*
+ * evaluateBatch: Evaluates a program for many rows of variable values.
+ * Explanation: columns[v][r] is the value of variable v in row r, and results[r] receives the
+ * result of row r. Rows are processed in blocks of BATCH_BLOCK: each stack slot holds a whole block
+ * of values, so every instruction is dispatched once per block and its work is a simple loop over
+ * arrays that the compiler can vectorize.
+ */
+void evaluateBatch(const Program *p, const double *const *columns, int rows, double *results) {
+    double *stack = (double*)malloc((size_t)p->maxDepth * BATCH_BLOCK * sizeof(double));
+    if(stack == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int start = 0; start < rows; start += BATCH_BLOCK) {
+        int n = rows - start < BATCH_BLOCK ? rows - start : BATCH_BLOCK;
+        double *top = stack - BATCH_BLOCK;  // Block on top of the stack.
+        for(int i = 0; i < p->length; i++) {
+            Instruction in = p->code[i];
+            if(in.op == OP_CONST) {
+                top += BATCH_BLOCK;
+                double value = p->constants[in.arg];
+                for(int r = 0; r < n; r++)
+                    top[r] = value;
+                continue;
+            }
+            if(in.op == OP_VAR) {
+                top += BATCH_BLOCK;
+                memcpy(top, columns[in.arg] + start, n * sizeof(double));
+                continue;
+            }
+            if(in.op == OP_NEG) {
+                for(int r = 0; r < n; r++)
+                    top[r] = -top[r];
+                continue;
+            }
+            double *restrict x = top - BATCH_BLOCK;
+            const double *restrict y = top;
+            switch(in.op) {
+                case OP_ADD: for(int r = 0; r < n; r++) x[r] += y[r]; break;
+                case OP_SUB: for(int r = 0; r < n; r++) x[r] -= y[r]; break;
+                case OP_MUL: for(int r = 0; r < n; r++) x[r] *= y[r]; break;
+                case OP_DIV: for(int r = 0; r < n; r++) x[r] /= y[r]; break;
+                default:     for(int r = 0; r < n; r++) x[r] = pow(x[r], y[r]); break;
+            }
+            top = x;
+        }
+        memcpy(results + start, stack, n * sizeof(double));
+    }
+    free(stack);
+}
+
+/*
+ * Expression DAG
+ * Explanation: buildDag reads the same postfix token stream as compileExpression but builds a
+ * directed acyclic graph instead of a linear program, optimizing while it goes:
+ *   - constant folding: an operation whose operands are all constants becomes a constant;
+ *   - simplification: x*1, 1*x, x+0, 0+x, x-0, x/1 and x^1 become x, x^0 becomes 1 and --x is x
+ *     (x*0 is kept, since it is not 0 when x is infinite or NaN);
+ *   - hash-consing: every node is looked up in a hash table before it is created, so identical
+ *     subexpressions (also a+b and b+a) become one node and are computed once.
+ * finishDag then lists the nodes the result depends on in evaluation order, and evaluateDag runs
+ * that list for one set of variable values.
+ */
+
+// One DAG node. Operands always have smaller indices than the node itself.
+typedef struct {
+    unsigned char op;           // OpCode.
+    int left, right;            // Operand nodes, -1 if unused; variable index for OP_VAR.
+    double value;               // Value of an OP_CONST node.
+} DagNode;
+
+DEFINE_STACK(IntStack, int, Int, STACK_INLINE_CAPACITY)
+
+typedef struct {
+    DagNode *nodes;             // All nodes created, in creation order.
+    int count;
+    int capacity;
+    int *table;                 // Hash table of node indices, -1 for an empty slot.
+    int tableSize;              // Power of two, at least twice count.
+    IntStack operands;          // Nodes of the operands seen so far, while building.
+    char variables[MAX_VARIABLES][MAX_NAME + 1];
+    int variableCount;
+    int root;                   // Node of the whole expression.
+    DagNode *steps;             // Nodes the root depends on, renumbered, in evaluation order.
+    int stepCount;
+    double *slots;              // One value per step during evaluation.
+} Dag;
+
+/*
+ * initDag / freeDag: Set up an empty DAG and release one.
+ */
+void initDag(Dag *d) {
+    memset(d, 0, sizeof(*d));
+    initIntStack(&d->operands);
+    d->root = -1;
+}
+
+void freeDag(Dag *d) {
+    free(d->nodes);
+    free(d->table);
+    free(d->steps);
+    free(d->slots);
+    freeIntStack(&d->operands);
+    initDag(d);
+}
+
+// hashNode: Mixes the fields of a node into one hash value.
+static unsigned int hashNode(const DagNode *n) {
+    unsigned long long bits;
+    memcpy(&bits, &n->value, sizeof(bits));
+    unsigned long long h = bits ^ ((unsigned long long)n->op << 56);
+    h ^= (unsigned long long)(unsigned int)n->left * 0x9E3779B97F4A7C15ull;
+    h ^= (unsigned long long)(unsigned int)n->right * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return (unsigned int)(h ^ (h >> 29));
+}
+
+static int sameNode(const DagNode *a, const DagNode *b) {
+    return a->op == b->op && a->left == b->left && a->right == b->right
+        && memcmp(&a->value, &b->value, sizeof(double)) == 0;
+}
+
+// growDagTable: Doubles the hash table and inserts every node again.
+static void growDagTable(Dag *d) {
+    int size = d->tableSize ? d->tableSize * 2 : 64;
+    int *table = (int*)malloc(size * sizeof(int));
+    if(table == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    memset(table, -1, size * sizeof(int));
+    for(int i = 0; i < d->count; i++) {
+        unsigned int slot = hashNode(&d->nodes[i]) & (size - 1);
+        while(table[slot] != -1)
+            slot = (slot + 1) & (size - 1);
+        table[slot] = i;
+    }
+    free(d->table);
+    d->table = table;
+    d->tableSize = size;
+}
+
+/*
+ * internNode: Returns the index of the node equal to n, creating it if there is none yet.
+ */
+int internNode(Dag *d, DagNode n) {
+    if(2 * (d->count + 1) > d->tableSize)
+        growDagTable(d);
+    unsigned int slot = hashNode(&n) & (d->tableSize - 1);
+    while(d->table[slot] != -1) {
+        if(sameNode(&d->nodes[d->table[slot]], &n))
+            return d->table[slot];
+        slot = (slot + 1) & (d->tableSize - 1);
+    }
+    if(d->count == d->capacity) {
+        d->capacity = d->capacity ? d->capacity * 2 : 64;
+        d->nodes = (DagNode*)realloc(d->nodes, d->capacity * sizeof(DagNode));
+        if(d->nodes == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    d->nodes[d->count] = n;
+    d->table[slot] = d->count;
+    return d->count++;
+}
+
+// Leaves and constants.
+static int constantNode(Dag *d, double value) {
+    DagNode n = { OP_CONST, -1, -1, value };
+    return internNode(d, n);
+}
+
+// isConstant: Compares bit patterns, so isConstant(d, node, 0) is false for a -0 node.
+static int isConstant(const Dag *d, int node, double value) {
+    return d->nodes[node].op == OP_CONST && memcmp(&d->nodes[node].value, &value, sizeof(double)) == 0;
+}
+
+/*
+ * operationNode: Returns the node for left op right (right is -1 for OP_NEG), simplified.
+ * Explanation: Only rewrites that hold for every double are applied. x-0 is x, but x+0 is not
+ * (-0 + 0 is +0), so additions of 0 are kept.
+ */
+int operationNode(Dag *d, OpCode op, int left, int right) {
+    const DagNode *l = &d->nodes[left];
+    if(op == OP_NEG) {
+        if(l->op == OP_CONST)
+            return constantNode(d, -l->value);
+        if(l->op == OP_NEG)
+            return l->left;
+    } else {
+        const DagNode *r = &d->nodes[right];
+        if(l->op == OP_CONST && r->op == OP_CONST)
+            return constantNode(d, applyOperator(op, l->value, r->value));
+        switch(op) {
+            case OP_ADD:
+                break;
+            case OP_SUB:
+                if(isConstant(d, right, 0)) return left;
+                break;
+            case OP_MUL:
+                if(isConstant(d, right, 1)) return left;
+                if(isConstant(d, left, 1)) return right;
+                break;
+            case OP_DIV:
+                if(isConstant(d, right, 1)) return left;
+                break;
+            default:
+                if(isConstant(d, right, 1)) return left;
+                if(isConstant(d, right, 0)) return constantNode(d, 1);   // Even for x NaN.
+                break;
+        }
+        if((op == OP_ADD || op == OP_MUL) && left > right) {
+            int swap = left;    // Commutative: one order for a+b and b+a.
+            left = right;
+            right = swap;
+        }
+    }
+    DagNode n = { (unsigned char)op, left, right, 0 };
+    return internNode(d, n);
+}
+
+/*
+ * buildDagToken: Adds one postfix token to the DAG being built.
+ */
+int buildDagToken(void *context, const Token *t) {
+    Dag *d = (Dag*)context;
+    if(t->type == TOKEN_NUMBER) {
+        pushInt(&d->operands, constantNode(d, t->value));
+        return 0;
+    }
+    if(t->type == TOKEN_NAME) {
+        int index = variableIndex(d->variables, &d->variableCount, t->text);
+        if(index < 0) {
+            if(!quietErrors)
+                printf("Too many variables in the expression.\n");
+            return -1;
+        }
+        DagNode n = { OP_VAR, index, -1, 0 };
+        pushInt(&d->operands, internNode(d, n));
+        return 0;
+    }
+    OpCode op = operatorCode(t->op);
+    if(op == OP_NEG) {
+        pushInt(&d->operands, operationNode(d, OP_NEG, popInt(&d->operands), -1));
+        return 0;
+    }
+    int right = popInt(&d->operands);
+    int left = popInt(&d->operands);
+    pushInt(&d->operands, operationNode(d, op, left, right));
+    return 0;
+}
+
+/*
+ * finishDag: Lists the nodes the root depends on, in evaluation order.
+ * Explanation: Nodes left behind by folding (such as the operands of a folded constant) are
+ * skipped. The steps are renumbered so that step i writes slots[i].
+ */
+void finishDag(Dag *d) {
+    int *number = (int*)malloc(d->count * sizeof(int));
+    if(number == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int i = 0; i < d->count; i++)
+        number[i] = 0;
+    number[d->root] = 1;
+    for(int i = d->root; i >= 0; i--) {     // Operands come before the nodes that use them.
+        if(number[i] && d->nodes[i].op != OP_CONST && d->nodes[i].op != OP_VAR) {
+            number[d->nodes[i].left] = 1;
+            if(d->nodes[i].right >= 0)
+                number[d->nodes[i].right] = 1;
+        }
+    }
+    d->stepCount = 0;
+    for(int i = 0; i <= d->root; i++) {
+        if(number[i])
+            number[i] = d->stepCount++;
+        else
+            number[i] = -1;
+    }
+    d->steps = (DagNode*)malloc(d->stepCount * sizeof(DagNode));
+    d->slots = (double*)malloc(d->stepCount * sizeof(double));
+    if(d->steps == NULL || d->slots == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int i = 0; i <= d->root; i++) {
+        if(number[i] < 0)
+            continue;
+        DagNode step = d->nodes[i];
+        if(step.op != OP_CONST && step.op != OP_VAR) {
+            step.left = number[step.left];
+            if(step.right >= 0)
+                step.right = number[step.right];
+        }
+        d->steps[number[i]] = step;
+    }
+    free(number);
+}
+
+/*
+ * buildDag: Builds the optimized DAG of an infix expression.
+ * Returns 0 on success; on error it prints a message and returns -1 with d left empty.
+ */
+int buildDag(const char *infix, Dag *d) {
+    TokenReader r;
+    CharStack operators;
+    initDag(d);
+    initStringReader(&r, infix, strlen(infix));
+    initCharStack(&operators);
+    int status = convertExpression(&r, &operators, buildDagToken, d);
+    freeCharStack(&operators);
+    if(status != 0) {
+        freeDag(d);
+        return -1;
+    }
+    d->root = popInt(&d->operands);
+    finishDag(d);
+    return 0;
+}
+
+/*
+ * printDag: Prints the evaluation steps, one per line ("t3 = t1 * t2").
+ */
+void printDag(const Dag *d) {
+    static const char symbols[] = { 0, 0, '-', '+', '-', '*', '/', '^' };
+    for(int i = 0; i < d->stepCount; i++) {
+        DagNode s = d->steps[i];
+        if(s.op == OP_CONST)
+            printf("  t%d = %g\n", i, s.value);
+        else if(s.op == OP_VAR)
+            printf("  t%d = %s\n", i, d->variables[s.left]);
+        else if(s.op == OP_NEG)
+            printf("  t%d = -t%d\n", i, s.left);
+        else
+            printf("  t%d = t%d %c t%d\n", i, s.left, symbols[s.op], s.right);
+    }
+}
+
+/*
+ * evaluateDag: Evaluates the DAG for one set of variable values (values[v] for variable v).
+ * Explanation: Every step is computed exactly once and the result is the last step.
+ */
+double evaluateDag(Dag *d, const double *values) {
+    double *slot = d->slots;
+    const DagNode *steps = d->steps;
+    for(int i = 0; i < d->stepCount; i++) {
+        DagNode s = steps[i];
+        switch(s.op) {
+            case OP_CONST: slot[i] = s.value; break;
+            case OP_VAR:   slot[i] = values[s.left]; break;
+            case OP_NEG:   slot[i] = -slot[s.left]; break;
+            case OP_ADD:   slot[i] = slot[s.left] + slot[s.right]; break;
+            case OP_SUB:   slot[i] = slot[s.left] - slot[s.right]; break;
+            case OP_MUL:   slot[i] = slot[s.left] * slot[s.right]; break;
+            case OP_DIV:   slot[i] = slot[s.left] / slot[s.right]; break;
+            default:       slot[i] = pow(slot[s.left], slot[s.right]); break;
+        }
+    }
+    return slot[d->stepCount - 1];
+}
+
+/*
+ * Expression cache
+ * Explanation: An ExpressionCache remembers the compiled form of recently seen expressions, so a
+ * repeated expression is not parsed again. Its key is the normalized expression: the text with
+ * whitespace removed, except for one space where removing it would join two tokens ("1 2" stays
+ * apart from "12"). The key is hashed with FNV-1a and looked up in a chained hash table; equal
+ * hashes are confirmed by comparing the keys. An entry holds:
+ *   - for a constant expression, its value, also formatted as text for output (the bytecode is
+ *     not needed any more);
+ *   - for an expression with variables, its compiled Program;
+ *   - for an invalid expression, just that fact, so it is rejected again without parsing.
+ * At most capacity entries are kept; when the cache is full the least recently used entry is
+ * evicted. Entries form a doubly linked LRU list through their indices, most recent first.
+ * A cache is not synchronized: every thread uses its own.
+ */
+
+#define CACHE_EMPTY -1
+
+// One cached expression.
+typedef struct {
+    char *key;                  // Normalized expression.
+    size_t keyLength;
+    unsigned long long hash;
+    int valid;                  // 0 for an invalid expression.
+    double value;               // Value of a constant expression.
+    char valueText[32];         // value printed with "%.17g", so a hit needs no formatting.
+    Program *program;           // Compiled expression if it has variables, NULL otherwise.
+    int newer, older;           // Neighbours in the LRU list.
+    int chain;                  // Next entry in the same hash bucket.
+} CacheEntry;
+
+typedef struct {
+    CacheEntry *entries;
+    int capacity;
+    int count;
+    int *buckets;               // First entry of each bucket, CACHE_EMPTY if none.
+    int bucketCount;            // Power of two, at least twice capacity.
+    int newest, oldest;         // Ends of the LRU list.
+    char *scratch;              // Buffer for the key being looked up.
+    size_t scratchCapacity;
+    long long lookups, hits, evictions;
+} ExpressionCache;
+
+/*
+ * initCache / freeCache: Set up an empty cache for capacity expressions and release one.
+ */
+void initCache(ExpressionCache *c, int capacity) {
+    memset(c, 0, sizeof(*c));
+    c->capacity = capacity;
+    c->bucketCount = 16;
+    while(c->bucketCount < 2 * capacity)
+        c->bucketCount *= 2;
+    c->entries = (CacheEntry*)malloc(capacity * sizeof(CacheEntry));
+    c->buckets = (int*)malloc(c->bucketCount * sizeof(int));
+    if(c->entries == NULL || c->buckets == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int i = 0; i < c->bucketCount; i++)
+        c->buckets[i] = CACHE_EMPTY;
+    c->newest = c->oldest = CACHE_EMPTY;
+}
+
+// releaseEntry: Frees what an entry owns.
+static void releaseEntry(CacheEntry *e) {
+    free(e->key);
+    if(e->program != NULL) {
+        freeProgram(e->program);
+        free(e->program);
+    }
+}
+
+void freeCache(ExpressionCache *c) {
+    for(int i = 0; i < c->count; i++)
+        releaseEntry(&c->entries[i]);
+    free(c->entries);
+    free(c->buckets);
+    free(c->scratch);
+    memset(c, 0, sizeof(*c));
+}
+
+/*
+ * normalizeExpression: Writes the normalized form of text (length bytes) to c->scratch.
+ * Returns the length of the normalized form.
+ */
+static size_t normalizeExpression(ExpressionCache *c, const char *text, size_t length) {
+    if(length + 1 > c->scratchCapacity) {
+        c->scratchCapacity = (length + 1) * 2;
+        c->scratch = (char*)realloc(c->scratch, c->scratchCapacity);
+        if(c->scratch == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    size_t n = 0;
+    int skipped = 0;
+    for(size_t i = 0; i < length; i++) {
+        unsigned char ch = (unsigned char)text[i];
+        if(isspace(ch)) {
+            skipped = 1;
+            continue;
+        }
+        // Keep one space between two characters that would otherwise form one token.
+        if(skipped && n > 0 && (isalnum(ch) || ch == '.' || ch == '_')) {
+            unsigned char last = (unsigned char)c->scratch[n - 1];
+            if(isalnum(last) || last == '.' || last == '_')
+                c->scratch[n++] = ' ';
+        }
+        skipped = 0;
+        c->scratch[n++] = (char)ch;
+    }
+    c->scratch[n] = '\0';
+    return n;
+}
+
+// unlinkEntry / linkNewest: Take an entry out of the LRU list and put it at the front.
+static void unlinkEntry(ExpressionCache *c, int i) {
+    CacheEntry *e = &c->entries[i];
+    if(e->newer != CACHE_EMPTY)
+        c->entries[e->newer].older = e->older;
+    else
+        c->newest = e->older;
+    if(e->older != CACHE_EMPTY)
+        c->entries[e->older].newer = e->newer;
+    else
+        c->oldest = e->newer;
+}
+
+static void linkNewest(ExpressionCache *c, int i) {
+    CacheEntry *e = &c->entries[i];
+    e->newer = CACHE_EMPTY;
+    e->older = c->newest;
+    if(c->newest != CACHE_EMPTY)
+        c->entries[c->newest].newer = i;
+    c->newest = i;
+    if(c->oldest == CACHE_EMPTY)
+        c->oldest = i;
+}
+
+// evictOldest: Removes the least recently used entry and returns its index for reuse.
+static int evictOldest(ExpressionCache *c) {
+    int i = c->oldest;
+    CacheEntry *e = &c->entries[i];
+    int *link = &c->buckets[e->hash & (c->bucketCount - 1)];
+    while(*link != i)
+        link = &c->entries[*link].chain;
+    *link = e->chain;
+    unlinkEntry(c, i);
+    releaseEntry(e);
+    c->evictions++;
+    return i;
+}
+
+/*
+ * cacheLookup: Returns the cache entry of an expression (length bytes, need not end in '\0').
+ * Explanation: On a hit the entry becomes the most recent one and nothing is parsed. On a miss the
+ * normalized expression is compiled, evaluated if it is constant, and stored. The entry stays
+ * valid until the next call.
+ */
+const CacheEntry *cacheLookup(ExpressionCache *c, const char *text, size_t length) {
+    size_t keyLength = normalizeExpression(c, text, length);
+    unsigned long long hash = 14695981039346656037ull;  // FNV-1a
+    for(size_t i = 0; i < keyLength; i++) {
+        hash ^= (unsigned char)c->scratch[i];
+        hash *= 1099511628211ull;
+    }
+    c->lookups++;
+    int *bucket = &c->buckets[hash & (c->bucketCount - 1)];
+    for(int i = *bucket; i != CACHE_EMPTY; i = c->entries[i].chain) {
+        CacheEntry *e = &c->entries[i];
+        if(e->hash == hash && e->keyLength == keyLength && memcmp(e->key, c->scratch, keyLength) == 0) {
+            c->hits++;
+            unlinkEntry(c, i);
+            linkNewest(c, i);
+            return e;
+        }
+    }
+
+    int i = c->count < c->capacity ? c->count++ : evictOldest(c);
+    CacheEntry *e = &c->entries[i];
+    e->key = (char*)malloc(keyLength + 1);
+    e->program = (Program*)malloc(sizeof(Program));
+    if(e->key == NULL || e->program == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(e->key, c->scratch, keyLength + 1);
+    e->keyLength = keyLength;
+    e->hash = hash;
+    e->value = 0;
+    e->valid = compileExpression(e->key, e->program) == 0;
+    e->valueText[0] = '\0';
+    int constant = 0;
+    if(e->valid && e->program->variableCount == 0) {
+        e->value = evaluateProgram(e->program, NULL);
+        constant = 1;
+    } else if(!e->valid) {
+        // The compiler has limits the streaming evaluator does not (MAX_VARIABLES and
+        // MAX_CONSTANTS), so a failed compile is checked again with evaluateExpression: the cache
+        // must never change a result.
+        TokenReader r;
+        initStringReader(&r, e->key, keyLength);
+        constant = e->valid = evaluateExpression(&r, &e->value) == 0;
+    }
+    if(constant)
+        snprintf(e->valueText, sizeof(e->valueText), "%.17g", e->value);
+    if(!e->valid || e->program->variableCount == 0) {
+        freeProgram(e->program);    // Only expressions with variables keep their bytecode.
+        free(e->program);
+        e->program = NULL;
+    }
+    e->chain = *bucket;
+    *bucket = i;
+    linkNewest(c, i);
+    return e;
+}
+
+/*
+ * printCacheStats: Prints the lookup, hit and eviction counters of a cache.
+ */
+void printCacheStats(FILE *out, long long lookups, long long hits, long long evictions) {
+    fprintf(out, "Cache: %lld lookups, %lld hits (%.1f%%), %lld evictions\n", lookups, hits,
+            lookups > 0 ? 100.0 * hits / lookups : 0.0, evictions);
+}
+
+/*
+ * nowSeconds: Returns a monotonic timestamp in seconds.
+ */
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * benchmarkBatch: Evaluates one formula over rows of random inputs in three ways.
+ * Explanation: Compiling and evaluating every row separately is what re-parsing the expression
+ * costs; the scalar interpreter dispatches once per value; evaluateBatch once per block.
+ */
+void benchmarkBatch(const char *infix, int rows) {
+    Program p;
+    if(compileExpression(infix, &p) != 0)
+        return;
+    double *data = (double*)malloc((size_t)(p.variableCount + 2) * rows * sizeof(double));
+    if(data == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    const double *columns[MAX_VARIABLES];
+    double *scalarResults = data + (size_t)p.variableCount * rows;
+    double *batchResults = scalarResults + rows;
+    unsigned int seed = 12345;
+    for(int v = 0; v < p.variableCount; v++) {
+        double *column = data + (size_t)v * rows;
+        for(int r = 0; r < rows; r++) {
+            seed = seed * 1103515245u + 12345u;
+            column[r] = 1.0 + (seed >> 8) % 1000 / 100.0;   // Values in [1, 11)
+        }
+        columns[v] = column;
+    }
+    printf("Formula %s over %d rows (%d variables, %d instructions):\n",
+           infix, rows, p.variableCount, p.length);
+
+    // Re-parse per row, on a tenth of the rows.
+    int parsedRows = rows / 10 > 0 ? rows / 10 : 1;
+    double row[MAX_VARIABLES];
+    double sink = 0;
+    double start = nowSeconds();
+    for(int r = 0; r < parsedRows; r++) {
+        Program perRow;
+        compileExpression(infix, &perRow);
+        for(int v = 0; v < p.variableCount; v++)
+            row[v] = columns[v][r];
+        sink += evaluateProgram(&perRow, row);
+        freeProgram(&perRow);
+    }
+    double elapsed = nowSeconds() - start;
+    printf("  parse every row   : %8.1f M rows/s\n", parsedRows / elapsed / 1e6);
+
+    start = nowSeconds();
+    for(int r = 0; r < rows; r++) {
+        for(int v = 0; v < p.variableCount; v++)
+            row[v] = columns[v][r];
+        scalarResults[r] = evaluateProgram(&p, row);
+    }
+    elapsed = nowSeconds() - start;
+    printf("  compiled, per row : %8.1f M rows/s\n", rows / elapsed / 1e6);
+
+    start = nowSeconds();
+    evaluateBatch(&p, columns, rows, batchResults);
+    elapsed = nowSeconds() - start;
+    int mismatches = 0;
+    for(int r = 0; r < rows; r++) {
+        if(fabs(scalarResults[r] - batchResults[r]) > 1e-9 * (1 + fabs(scalarResults[r])))
+            mismatches++;
+    }
+    printf("  compiled, batch   : %8.1f M rows/s  (%s, checksum %g)\n", rows / elapsed / 1e6,
+           mismatches == 0 ? "same results" : "MISMATCH", sink);
+    free(data);
+    freeProgram(&p);
+}
+
+// randomBelow: A small LCG for the formula generator, so every run uses the same corpus.
+static unsigned int formulaSeed = 2024;
+
+static int randomBelow(int n) {
+    formulaSeed = formulaSeed * 1103515245u + 12345u;
+    return (int)((formulaSeed >> 16) % (unsigned int)n);
+}
+
+#define FORMULA_SIZE 16384   // Room for one generated formula.
+#define SHARED_TERMS 4       // Subexpressions a generated formula keeps reusing.
+
+/*
+ * appendFormula: Appends a random formula of the given depth to out (size bytes, pos used).
+ * Explanation: The formulas look like machine-generated ones: variables a to f, constant
+ * subterms such as (2*3.5) or (8-2)/4, unit factors (*1, +0, ^1), and repeated copies of a few
+ * shared subexpressions. Returns the new length.
+ */
+static int appendFormula(char *out, int pos, int size, int depth, char shared[][256]) {
+    static const char *constantTerms[] = { "(2*3.5)", "(8-2)/4", "2^3", "(1+1)*(3-0.5)", "-(4/8)" };
+    static const char *units[] = { "*1", "+0", "^1", "/1" };
+    static const char ops[] = "+-*/+*";
+    int choice = randomBelow(100);
+    if(depth == 0 || choice < 15) {
+        choice = randomBelow(100);
+        if(choice < 40)
+            return pos + snprintf(out + pos, size - pos, "%c", 'a' + randomBelow(6));
+        if(choice < 55)
+            return pos + snprintf(out + pos, size - pos, "%d.%d", randomBelow(10), randomBelow(10));
+        if(choice < 70 || shared == NULL)
+            return pos + snprintf(out + pos, size - pos, "%s", constantTerms[randomBelow(5)]);
+        return pos + snprintf(out + pos, size - pos, "(%s)", shared[randomBelow(SHARED_TERMS)]);
+    }
+    pos += snprintf(out + pos, size - pos, "(");
+    pos = appendFormula(out, pos, size, depth - 1, shared);
+    pos += snprintf(out + pos, size - pos, " %c ", ops[randomBelow(6)]);
+    pos = appendFormula(out, pos, size, depth - 1, shared);
+    pos += snprintf(out + pos, size - pos, ")%s", randomBelow(100) < 20 ? units[randomBelow(4)] : "");
+    return pos < size ? pos : size - 1;
+}
+
+/*
+ * benchmarkDag: Evaluates a corpus of generated formulas with and without the DAG optimizations.
+ * Explanation: Each formula is compiled to the plain stack program and built as an optimized DAG,
+ * then both are evaluated for the same rows of random variable values.
+ */
+void benchmarkDag(int formulas, int rows) {
+    char *text = (char*)malloc(FORMULA_SIZE);
+    double *values = (double*)malloc((size_t)rows * MAX_VARIABLES * sizeof(double));
+    if(text == NULL || values == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int i = 0; i < rows * MAX_VARIABLES; i++)
+        values[i] = 1.0 + randomBelow(1000) / 100.0;
+
+    long long instructions = 0, steps = 0;
+    double programTime = 0, dagTime = 0, sink = 0;
+    int mismatches = 0;
+    for(int f = 0; f < formulas; f++) {
+        char shared[SHARED_TERMS][256];
+        for(int k = 0; k < SHARED_TERMS; k++)
+            appendFormula(shared[k], 0, sizeof(shared[k]), 2, NULL);
+        appendFormula(text, 0, FORMULA_SIZE, 6, shared);
+
+        Program p;
+        Dag d;
+        if(compileExpression(text, &p) != 0 || buildDag(text, &d) != 0)
+            exit(1);
+        instructions += p.length;
+        steps += d.stepCount;
+
+        double start = nowSeconds();
+        for(int r = 0; r < rows; r++)
+            sink += evaluateProgram(&p, values + (size_t)r * MAX_VARIABLES);
+        programTime += nowSeconds() - start;
+        start = nowSeconds();
+        for(int r = 0; r < rows; r++)
+            sink -= evaluateDag(&d, values + (size_t)r * MAX_VARIABLES);
+        dagTime += nowSeconds() - start;
+
+        // Folding may round differently; the results must still agree closely.
+        double *row = values;
+        double x = evaluateProgram(&p, row), y = evaluateDag(&d, row);
+        if(!(fabs(x - y) <= 1e-9 * (1 + fabs(x))) && !(isnan(x) && isnan(y)) && x != y)
+            mismatches++;
+        if(f == 0) {
+            printf("Example formula: %s\n", text);
+            printf("  %d stack instructions, %d DAG steps:\n", p.length, d.stepCount);
+            printDag(&d);
+        }
+        freeProgram(&p);
+        freeDag(&d);
+    }
+    printf("Corpus of %d generated formulas, %d rows each:\n", formulas, rows);
+    printf("  stack program : %6.1f instructions/formula  %8.1f ms\n",
+           (double)instructions / formulas, programTime * 1e3);
+    printf("  optimized DAG : %6.1f steps/formula         %8.1f ms  (%.2fx faster, %s)\n",
+           (double)steps / formulas, dagTime * 1e3, programTime / dagTime,
+           mismatches == 0 ? "same results" : "MISMATCH");
+    if(sink == 1e300)
+        printf("\n");   // Keeps the evaluation loops from being optimized away.
+    free(text);
+    free(values);
+}
+
+/*
+ * processFile: Converts or evaluates one expression stored in a file, in constant memory.
+ * Explanation: The file is read in chunks, or mapped with mmap if useMmap is set. With toPostfix
+ * the postfix expression is written to stdout token by token; otherwise the value is printed.
+ * Returns 0 on success and 1 on error.
+ */
+int processFile(const char *path, int toPostfix, int useMmap) {
+    TokenReader r;
+    FILE *file = NULL;
+    if(useMmap) {
+        if(mapFileReader(&r, path) != 0)
+            return 1;
+    } else {
+        file = fopen(path, "rb");
+        if(file == NULL) {
+            printf("Cannot open %s.\n", path);
+            return 1;
+        }
+        initFileReader(&r, file);
+    }
+    int status;
+    if(toPostfix) {
+        CharStack operators;
+        PostfixText out = { stdout, NULL, 0, 0 };
+        initCharStack(&operators);
+        status = convertExpression(&r, &operators, writePostfixToken, &out);
+        freeCharStack(&operators);
+        putchar('\n');
+    } else {
+        double result;
+        status = evaluateExpression(&r, &result);
+        if(status == 0)
+            printf("Evaluation result: %.17g\n", result);
+    }
+    closeReader(&r);
+    if(file != NULL)
+        fclose(file);
+    return status == 0 ? 0 : 1;
+}
+
+/*
+ * Batch mode
+ * Explanation: evaluateBatchFile evaluates a file with one independent expression per line on a
+ * pool of threads. The file is mapped with mmap and cut into chunks of BATCH_CHUNK bytes; a chunk
+ * owns the lines that start inside it, so a thread finds its line boundaries on its own. Threads
+ * take the next chunk from a shared counter, evaluate its lines with their own CharStack and
+ * DoubleStack (reused for every line) and format the results into the chunk's output buffer.
+ * The main thread writes the buffers in chunk order as they complete, so the output has one line
+ * per input line, in input order: the value, "error" for an invalid line, or nothing for a blank one.
+ * Each thread also keeps its own ExpressionCache, so a line it has seen recently is not parsed again.
+ */
+
+#define BATCH_CHUNK (1 << 20)   // Bytes of input per chunk.
+#define BATCH_CACHE 4096        // Default cache entries per thread.
+
+// One chunk of the input and its formatted results.
+typedef struct {
+    char *output;
+    size_t length;
+    size_t capacity;
+    int done;                   // Set under the mutex when output is complete.
+} BatchChunk;
+
+// State shared by the batch threads.
+typedef struct {
+    const char *data;           // Mapped input.
+    size_t size;
+    BatchChunk *chunks;
+    int chunkCount;
+    atomic_int nextChunk;       // Next chunk a thread may take.
+    atomic_long expressions;    // Lines evaluated.
+    int cacheSize;              // Cache entries per thread, 0 for no cache.
+    long long lookups, hits, evictions;  // Cache counters of all threads, under the mutex.
+    pthread_mutex_t mutex;
+    pthread_cond_t chunkDone;   // Signalled whenever a chunk is complete.
+} BatchJob;
+
+// chunkStart: Offset of the first line that starts in chunk i.
+static size_t chunkStart(const BatchJob *job, int i) {
+    size_t pos = (size_t)i * BATCH_CHUNK;
+    if(pos == 0 || pos >= job->size)
+        return pos < job->size ? pos : job->size;
+    const char *newline = (const char*)memchr(job->data + pos - 1, '\n', job->size - pos + 1);
+    return newline == NULL ? job->size : (size_t)(newline - job->data) + 1;
+}
+
+// appendOutput: Appends text to the output buffer of a chunk.
+static void appendOutput(BatchChunk *c, const char *text, size_t n) {
+    if(c->length + n > c->capacity) {
+        c->capacity = (c->length + n) * 2;
+        c->output = (char*)realloc(c->output, c->capacity);
+        if(c->output == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    memcpy(c->output + c->length, text, n);
+    c->length += n;
+}
+
+/*
+ * batchWorker: Takes chunks until none are left and evaluates their lines.
+ */
+void *batchWorker(void *arg) {
+    BatchJob *job = (BatchJob*)arg;
+    CharStack operators;
+    DoubleStack values;
+    ExpressionCache cache;
+    initCharStack(&operators);
+    initDoubleStack(&values);
+    if(job->cacheSize > 0)
+        initCache(&cache, job->cacheSize);
+    int i;
+    while((i = atomic_fetch_add(&job->nextChunk, 1)) < job->chunkCount) {
+        BatchChunk *c = &job->chunks[i];
+        size_t pos = chunkStart(job, i), end = chunkStart(job, i + 1);
+        long count = 0;
+        char text[32];
+        while(pos < end) {
+            const char *line = job->data + pos;
+            const char *newline = (const char*)memchr(line, '\n', end - pos);
+            size_t length = newline != NULL ? (size_t)(newline - line) : end - pos;
+            pos += length + 1;
+            size_t k = 0;
+            while(k < length && isspace((unsigned char)line[k]))
+                k++;
+            if(k == length) {
+                appendOutput(c, "\n", 1);
+                continue;
+            }
+            int n;
+            if(job->cacheSize > 0) {
+                // Expressions with variables have no value here, like in evaluateToken.
+                const CacheEntry *e = cacheLookup(&cache, line, length);
+                if(e->valid && e->program == NULL)
+                    n = snprintf(text, sizeof(text), "%s\n", e->valueText);
+                else
+                    n = snprintf(text, sizeof(text), "error\n");
+            } else {
+                TokenReader r;
+                initStringReader(&r, line, length);
+                values.top = -1;
+                if(convertExpression(&r, &operators, evaluateToken, &values) == 0)
+                    n = snprintf(text, sizeof(text), "%.17g\n", popDouble(&values));
+                else
+                    n = snprintf(text, sizeof(text), "error\n");
+            }
+            appendOutput(c, text, (size_t)n);
+            count++;
+        }
+        atomic_fetch_add(&job->expressions, count);
+        pthread_mutex_lock(&job->mutex);
+        c->done = 1;
+        pthread_cond_broadcast(&job->chunkDone);
+        pthread_mutex_unlock(&job->mutex);
+    }
+    freeCharStack(&operators);
+    freeDoubleStack(&values);
+    if(job->cacheSize > 0) {
+        pthread_mutex_lock(&job->mutex);
+        job->lookups += cache.lookups;
+        job->hits += cache.hits;
+        job->evictions += cache.evictions;
+        pthread_mutex_unlock(&job->mutex);
+        freeCache(&cache);
+    }
+    return NULL;
+}
+
+/*
+ * evaluateBatchFile: Evaluates every line of path on threads threads and writes the results to
+ * out. cacheSize is the number of cache entries per thread (0 turns the cache off). Throughput and
+ * cache counters are reported on stderr, so out holds only results. Returns 0 on success.
+ */
+int evaluateBatchFile(const char *path, int threads, int cacheSize, FILE *out) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if(fd < 0 || fstat(fd, &info) != 0) {
+        printf("Cannot open %s.\n", path);
+        if(fd >= 0)
+            close(fd);
+        return 1;
+    }
+    BatchJob job;
+    job.size = (size_t)info.st_size;
+    job.data = NULL;
+    if(job.size > 0) {
+        void *mapping = mmap(NULL, job.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            printf("Cannot map %s.\n", path);
+            close(fd);
+            return 1;
+        }
+        madvise(mapping, job.size, MADV_SEQUENTIAL);
+        job.data = (const char*)mapping;
+    }
+    close(fd);
+    job.chunkCount = (int)((job.size + BATCH_CHUNK - 1) / BATCH_CHUNK);
+    job.chunks = (BatchChunk*)calloc(job.chunkCount > 0 ? job.chunkCount : 1, sizeof(BatchChunk));
+    pthread_t *pool = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    if(job.chunks == NULL || pool == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    atomic_init(&job.nextChunk, 0);
+    atomic_init(&job.expressions, 0);
+    job.cacheSize = cacheSize;
+    job.lookups = job.hits = job.evictions = 0;
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.chunkDone, NULL);
+    quietErrors = 1;
+
+    double start = nowSeconds();
+    for(int t = 0; t < threads; t++)
+        pthread_create(&pool[t], NULL, batchWorker, &job);
+    // Write the chunks in order as soon as each is complete, and free them right away.
+    for(int i = 0; i < job.chunkCount; i++) {
+        pthread_mutex_lock(&job.mutex);
+        while(!job.chunks[i].done)
+            pthread_cond_wait(&job.chunkDone, &job.mutex);
+        pthread_mutex_unlock(&job.mutex);
+        fwrite(job.chunks[i].output, 1, job.chunks[i].length, out);
+        free(job.chunks[i].output);
+    }
+    for(int t = 0; t < threads; t++)
+        pthread_join(pool[t], NULL);
+    fflush(out);
+    double elapsed = nowSeconds() - start;
+
+    long expressions = atomic_load(&job.expressions);
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(cores <= 0 || cores > threads)
+        cores = threads;    // Threads beyond the number of cores share them.
+    fprintf(stderr, "Evaluated %ld expressions in %.3f s on %d threads: %.2f M expressions/s, "
+            "%.2f M expressions/s per core (%d cores)\n", expressions, elapsed, threads,
+            expressions / elapsed / 1e6, expressions / elapsed / 1e6 / cores, cores);
+    if(cacheSize > 0)
+        printCacheStats(stderr, job.lookups, job.hits, job.evictions);
+    quietErrors = 0;
+    pthread_mutex_destroy(&job.mutex);
+    pthread_cond_destroy(&job.chunkDone);
+    if(job.data != NULL)
+        munmap((void*)job.data, job.size);
+    free(job.chunks);
+    free(pool);
+    return 0;
 }
 
 /*
  * main: Demonstrates the infix to postfix conversion and postfix evaluation.
  * Explanation: Reads an infix expression from the user, converts it to a postfix expression,
  * evaluates the postfix expression, and prints both the converted expression and the evaluation result.
+ * An expression with variables is compiled and built as an optimized DAG instead, and the program
+ * asks for their values.
+ * Other modes:
+ *   ./infixPostfix --eval file [--mmap]      evaluate the expression in a file of any size
+ *   ./infixPostfix --postfix file [--mmap]   write its postfix form to stdout
+ *   ./infixPostfix --batch file [threads] [cacheSize]
+ *                                            evaluate one expression per line, in parallel
+ *   ./infixPostfix --bench [rows]            run the batch evaluation benchmark
  */
-int main() {
-    char infixExp[MAX];
-    char postfixExp[MAX];
-    
-    printf("Enter an infix expression (use single-digit operands): ");
-    scanf("%s", infixExp);
+int main(int argc, char *argv[]) {
+    if(argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int rows = argc > 2 ? atoi(argv[2]) : 4000000;
+        if(rows <= 0) {
+            printf("Usage: %s --bench [rows]\n", argv[0]);
+            return 1;
+        }
+        benchmarkBatch("(a+b)*(c-d)/(a+2)", rows);
+        benchmarkBatch("a*a+b*b+c*c+d*d-2*(a*b+c*d)", rows);
+        printf("\n");
+        benchmarkDag(200, rows / 200 > 0 ? rows / 200 : 1);
+        return 0;
+    }
+    if(argc > 1 && (strcmp(argv[1], "--eval") == 0 || strcmp(argv[1], "--postfix") == 0)) {
+        if(argc < 3 || (argc > 3 && strcmp(argv[3], "--mmap") != 0)) {
+            printf("Usage: %s %s file [--mmap]\n", argv[0], argv[1]);
+            return 1;
+        }
+        return processFile(argv[2], strcmp(argv[1], "--postfix") == 0, argc > 3);
+    }
+    if(argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        int threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        int cacheSize = argc > 4 ? atoi(argv[4]) : BATCH_CACHE;
+        if(argc < 3 || threads <= 0 || cacheSize < 0) {
+            printf("Usage: %s --batch file [threads] [cacheSize (0 = off)]\n", argv[0]);
+            return 1;
+        }
+        return evaluateBatchFile(argv[2], threads, cacheSize, stdout);
+    }
+
+    // The line is read with getline, so it may be of any length.
+    char *infixExp = NULL;
+    size_t size = 0;
+    printf("Enter an infix expression: ");
+    if(getline(&infixExp, &size, stdin) < 0) {
+        free(infixExp);
+        return 1;
+    }
     
     // Convert the infix expression to postfix.
-    infixToPostfix(infixExp, postfixExp);
+    char *postfixExp = infixToPostfix(infixExp);
+    if(postfixExp == NULL) {
+        free(infixExp);
+        return 1;
+    }
     printf("Postfix expression: %s\n", postfixExp);
+
+    Program program;
+    int status = 0;
+    if(compileExpression(infixExp, &program) != 0) {
+        // The compiler limits variables and constants but the streaming evaluator does not, so an
+        // expression that only has too many constants is still evaluated.
+        TokenReader r;
+        double result;
+        initStringReader(&r, infixExp, strlen(infixExp));
+        quietErrors = 1;
+        status = evaluateExpression(&r, &result) == 0 ? 0 : 1;
+        quietErrors = 0;
+        if(status == 0)
+            printf("Evaluation result: %g\n", result);
+    } else if(program.variableCount == 0) {
+        // Evaluate the postfix expression.
+        double result = evaluatePostfix(postfixExp);
+        printf("Evaluation result: %g\n", result);
+    } else {
+        printf("Compiled program:\n");
+        printProgram(&program);
+        Dag dag;
+        if(buildDag(infixExp, &dag) != 0) {
+            status = 1;
+        } else {
+            printf("Optimized DAG:\n");
+            printDag(&dag);
+            double values[MAX_VARIABLES];
+            for(int v = 0; v < dag.variableCount && status == 0; v++) {
+                printf("Value of %s: ", dag.variables[v]);
+                if(scanf("%lf", &values[v]) != 1) {
+                    printf("Invalid value.\n");
+                    status = 1;
+                }
+            }
+            if(status == 0)
+                printf("Evaluation result: %g\n", evaluateDag(&dag, values));
+            freeDag(&dag);
+        }
+    }
+    freeProgram(&program);
+    free(postfixExp);
+    free(infixExp);
     
-    // Evaluate the postfix expression.
-    int result = evaluatePostfix(postfixExp);
-    printf("Evaluation result: %d\n", result);
-    
-    return 0;
+    return status;
 }
-
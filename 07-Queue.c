@@ -1,119 +1,60 @@
 #include <stdio.h>
-#include <stdlib.h>
-#include <limits.h>
-
-#define MAX 100  // Maximum capacity of the queue
-
-// Define the Queue structure using an array.
-typedef struct {
-    int items[MAX]; // Array to store queue elements.
-    int front;      // Index of the front element.
-    int rear;       // Index of the rear element.
-} Queue;
-
-/*
- * createQueue: Allocates memory for a new queue and initializes its members.
- * Returns a pointer to the newly created Queue.
- */
-Queue* createQueue() {
-    Queue* q = (Queue*)malloc(sizeof(Queue));
-    q->front = -1;
-    q->rear = -1;
-    return q;
-}
+#include "ringQueue.h"
 
 /*
- * isEmpty: Checks if the queue is empty.
- * Returns 1 (true) if the queue is empty, 0 (false) otherwise.
+ * Queue: A growable ring buffer of ints from ringQueue.h.
+ * Explanation: The elements live in a circular array with a power-of-two capacity, so dequeued
+ * slots are reused and a full queue doubles on the next enqueue. This provides createQueue,
+ * freeQueue, isEmpty, isFull, size, reserve, enqueue, dequeue, enqueueMany, dequeueMany,
+ * frontElement and displayQueue.
  */
-int isEmpty(Queue* q) {
-    return q->front == -1;
-}
-
-/*
- * isFull: Checks if the queue is full.
- * Returns 1 (true) if the queue is full, 0 (false) otherwise.
- */
-int isFull(Queue* q) {
-    return q->rear == MAX - 1;
-}
 
 /*
- * enqueue: Adds a new element to the rear of the queue.
- * If the queue is full, it prints an error message.
- * Explanation: This function inserts the given value at the end of the queue.
+ * checkAgainstModel: Runs random single and batch enqueues and dequeues against a plain array
+ * and checks size, front element and every dequeued value after each step.
+ * Explanation: The positions start just below UINT_MAX, so head and tail cross it while the queue
+ * is still small; later the queue grows while its elements wrap around the end of the array.
+ * Returns 1 if everything matched and both of those cases happened.
  */
-void enqueue(Queue* q, int value) {
-    if (isFull(q)) {
-        printf("Queue is full. Cannot enqueue %d\n", value);
-        return;
-    }
-    if (isEmpty(q)) {
-        // If the queue is empty, initialize the front index.
-        q->front = 0;
-    }
-    q->rear++;
-    q->items[q->rear] = value;
-}
-
-/*
- * dequeue: Removes and returns the front element of the queue.
- * If the queue is empty, it prints an error message and returns INT_MIN.
- * Explanation: This function removes the element from the front of the queue and returns it.
- */
-int dequeue(Queue* q) {
-    if (isEmpty(q)) {
-        printf("Queue is empty. Cannot dequeue.\n");
-        return INT_MIN;
-    }
-    int value = q->items[q->front];
-    // If the queue has only one element, reset the queue after removal.
-    if (q->front == q->rear) {
-        q->front = -1;
-        q->rear = -1;
-    } else {
-        q->front++;
-    }
-    return value;
-}
-
-/*
- * frontElement: Returns the element at the front of the queue without removing it.
- * If the queue is empty, it prints an error message and returns INT_MIN.
- * Explanation: This function retrieves the front element without dequeuing it.
- */
-int frontElement(Queue* q) {
-    if (isEmpty(q)) {
-        printf("Queue is empty. No front element.\n");
-        return INT_MIN;
-    }
-    return q->items[q->front];
-}
-
-/*
- * displayQueue: Prints all the elements in the queue from front to rear.
- * Explanation: This function traverses the queue from the front index to the rear index and prints each element.
- */
-void displayQueue(Queue* q) {
-    if (isEmpty(q)) {
-        printf("Queue is empty.\n");
-        return;
-    }
-    for (int i = q->front; i <= q->rear; i++) {
-        printf("%d ", q->items[i]);
-    }
-    printf("\n");
-}
-
-/*
- * size: Returns the number of elements currently in the queue.
- * Explanation: This function calculates the current size by subtracting the front index from the rear index and adding one.
- */
-int size(Queue* q) {
-    if (isEmpty(q)) {
-        return 0;
+int checkAgainstModel(void) {
+    enum { STEPS = 20000, BATCH = 40 };
+    static int model[STEPS * BATCH];
+    int front = 0, back = 0, crossed = 0, wrappedGrow = 0, ok = 1;
+    int values[BATCH], out[BATCH];
+    unsigned int seed = 11;
+    Queue* q = createQueue();
+    q->head = q->tail = UINT_MAX - 20;
+    for (int step = 0; step < STEPS && ok; step++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int r = seed >> 8;
+        int early = step < 200;               // Stay below the initial capacity for a while.
+        int count = 1 + (int)((r >> 4) % (early ? 4 : BATCH));
+        int single = r % 2 == 0;
+        if (single) count = 1;
+        int add = early ? size(q) < 8 : r % 3 != 0;
+        if (add) {
+            if ((unsigned int)(size(q) + count) > q->capacity &&
+                (q->head & q->mask) + (unsigned int)size(q) > q->capacity) {
+                wrappedGrow = 1;
+            }
+            for (int i = 0; i < count; i++) {
+                values[i] = step * BATCH + i;
+                model[back++] = values[i];
+            }
+            if (single) enqueue(q, values[0]);
+            else enqueueMany(q, values, count);
+        } else if (single) {
+            if (front < back) ok = dequeue(q) == model[front++];
+        } else {
+            int removed = dequeueMany(q, out, count);
+            ok = removed == (back - front < count ? back - front : count);
+            for (int i = 0; i < removed && ok; i++) ok = out[i] == model[front++];
+        }
+        if (q->tail < q->head) crossed = 1;
+        if (size(q) != back - front || (front < back && frontElement(q) != model[front])) ok = 0;
     }
-    return q->rear - q->front + 1;
+    freeQueue(q);
+    return ok && crossed && wrappedGrow;
 }
 
 // Main function to demonstrate the Queue operations.
@@ -143,8 +84,31 @@ int main() {
     // Display the current size of the queue.
     printf("Queue size: %d\n", size(q));
 
+    // Slots are reused: a queue that never holds more than a few elements does not grow.
+    for (int i = 0; i < 1000; i++) {
+        enqueue(q, i);
+        dequeue(q);
+    }
+    printf("After 1000 more enqueue/dequeue pairs: size %d, capacity %u\n", size(q), q->capacity);
+
+    // Batch operations copy whole spans, wrapping around the end of the array.
+    int values[40], out[40];
+    dequeueMany(q, out, size(q));
+    for (int i = 0; i < 40; i++) {
+        values[i] = i + 1;
+    }
+    enqueueMany(q, values, 10);
+    int removed = dequeueMany(q, out, 6);
+    printf("Enqueued 10, dequeued %d: %d .. %d\n", removed, out[0], out[removed - 1]);
+    enqueueMany(q, values + 10, 30);
+    printf("Enqueued 30 more: size %d, capacity %u\n", size(q), q->capacity);
+    removed = dequeueMany(q, out, 40);
+    printf("Dequeued %d: %d .. %d\n", removed, out[0], out[removed - 1]);
+
     // Free the allocated memory for the queue.
-    free(q);
+    freeQueue(q);
+
+    printf("Random operations match a plain array across a wrap, a grow and UINT_MAX: %s\n",
+           checkAgainstModel() ? "ok" : "FAILED");
     return 0;
 }
-
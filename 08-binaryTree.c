@@ -8,13 +8,26 @@ typedef struct Node {
     struct Node* right;     // Pointer to the right child.
 } Node;
 
+/*
+ * Node allocation: Compile with -DUSE_NODE_POOL to take nodes from the slab allocator
+ * in nodePool.h instead of calling malloc/free for every node.
+ */
+#ifdef USE_NODE_POOL
+#include "nodePool.h"
+static NodePool nodePool = NODE_POOL_INITIALIZER(sizeof(Node));
+#endif
+
 /*
  * createNode: Creates a new binary tree node with the given data.
  * Explanation: This function allocates memory for a new node, initializes its data,
  * and sets both left and right children to NULL.
  */
 Node* createNode(int data) {
+#ifdef USE_NODE_POOL
+    Node* newNode = (Node*)poolAlloc(&nodePool);
+#else
     Node* newNode = (Node*)malloc(sizeof(Node));
+#endif
     if(newNode == NULL) {
         printf("Memory allocation error\n");
         exit(1);
@@ -24,6 +37,18 @@ Node* createNode(int data) {
     return newNode;
 }
 
+/*
+ * freeNode: Releases a node created by createNode.
+ * Explanation: Returns the node to the pool when USE_NODE_POOL is set, otherwise frees it.
+ */
+void freeNode(Node* node) {
+#ifdef USE_NODE_POOL
+    poolFree(&nodePool, node);
+#else
+    free(node);
+#endif
+}
+
 /*
  * insert: Inserts a new node with the given data into the binary search tree.
  * Explanation: This function recursively finds the correct position for the new data
@@ -132,11 +157,11 @@ Node* deleteNode(Node* root, int data) {
         // Node with one child or no child.
         if(root->left == NULL) {
             Node* temp = root->right;
-            free(root);
+            freeNode(root);
             return temp;
         } else if(root->right == NULL) {
             Node* temp = root->left;
-            free(root);
+            freeNode(root);
             return temp;
         }
         // Node with two children: Get the inorder successor (smallest in the right subtree)
@@ -163,6 +188,18 @@ int treeHeight(Node* root) {
     return (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
 }
 
+/*
+ * freeTree: Releases every node of the binary tree.
+ * Explanation: Uses a postorder walk so that children are freed before their parent.
+ */
+void freeTree(Node* root) {
+    if(root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        freeNode(root);
+    }
+}
+
 // Main function to demonstrate the binary search tree operations.
 int main() {
     Node* root = NULL;
@@ -208,5 +245,9 @@ int main() {
     int height = treeHeight(root);
     printf("Height of the tree: %d\n", height);
 
+    freeTree(root);
+#ifdef USE_NODE_POOL
+    poolDestroy(&nodePool); // Release the pool's slabs in one call.
+#endif
     return 0;
 }
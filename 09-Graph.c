@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include "priorityHeap.h"
 
 // Define the Graph structure using an adjacency matrix.
 // The matrix stores 0 (no edge) or 1 (edge exists) between vertices.
@@ -153,6 +155,52 @@ void BFS(Graph* graph, int startVertex) {
     free(queue);
 }
 
+/*
+ * Priority queue for shortest paths: the 4-ary heap from priorityHeap.h.
+ */
+DEFINE_HEAP(QuadHeap, Quad, 4)
+
+/*
+ * shortestPaths: Prints the length of the shortest path from startVertex to every vertex
+ * (Dijkstra's algorithm).
+ * Explanation: A matrix entry is used as the weight of its edge; addEdge stores 1, so here the
+ * length is the number of edges. The heap holds every vertex whose distance is known to be an
+ * upper bound. The vertex with the smallest bound is final when it is popped, and each of its
+ * edges may lower the bound of a neighbour, which decreaseKey applies in place.
+ */
+void shortestPaths(Graph* graph, int startVertex) {
+    int *dist = (int*)malloc(graph->numVertices * sizeof(int));
+    for (int i = 0; i < graph->numVertices; i++) {
+        dist[i] = INT_MAX;
+    }
+    QuadHeap heap;
+    initQuadHeap(&heap, graph->numVertices);
+    dist[startVertex] = 0;
+    pushQuad(&heap, startVertex, 0);
+    while (!isEmptyQuad(&heap)) {
+        int d;
+        int u = popQuad(&heap, &d);
+        for (int v = 0; v < graph->numVertices; v++) {
+            int weight = graph->adjMatrix[u][v];
+            if (weight > 0 && d + weight < dist[v]) {
+                dist[v] = d + weight;
+                decreaseKeyQuad(&heap, v, dist[v]);
+            }
+        }
+    }
+    printf("Shortest path lengths from vertex %d: ", startVertex);
+    for (int i = 0; i < graph->numVertices; i++) {
+        if (dist[i] == INT_MAX) {
+            printf("- ");
+        } else {
+            printf("%d ", dist[i]);
+        }
+    }
+    printf("\n");
+    freeQuadHeap(&heap);
+    free(dist);
+}
+
 // Main function to demonstrate the graph operations.
 int main() {
     int vertices = 5;
@@ -173,6 +221,7 @@ int main() {
     // Perform DFS and BFS traversals.
     DFS(graph, 0);
     BFS(graph, 0);
+    shortestPaths(graph, 0);
 
     // Remove an edge and print the graph again.
     printf("Removing edge between 1 and 4.\n");
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "nodePool.h"
+
+/*
+ * 10-nodePool.c: Demonstrates the slab node allocator from nodePool.h and benchmarks it
+ * against plain malloc/free for the node shapes used in 02, 03, 04 and 08.
+ * Usage: ./nodePool [numNodes]
+ */
+
+// Node shape of the singly and circular linked lists (02, 04).
+typedef struct ListNode {
+    int data;
+    struct ListNode* next;
+} ListNode;
+
+// Node shape of the binary search tree (08); also the size of a doubly linked node (03).
+typedef struct TreeNode {
+    int data;
+    struct TreeNode* left;
+    struct TreeNode* right;
+} TreeNode;
+
+#define CHURN_LIVE 4096  // Nodes kept alive while the churn benchmark allocates and frees.
+#define NUM_THREADS 4    // Threads used by the per-thread cache benchmark.
+
+/*
+ * nowSeconds: Returns a monotonic timestamp in seconds.
+ */
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * nextRandom: Small xorshift generator so both allocators see the same sequence.
+ */
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/*
+ * sumList: Traverses a list and returns the sum of its values.
+ * Explanation: Nodes that are close in memory make this walk cheaper, which is what the
+ * pool's slab layout provides.
+ */
+long long sumList(ListNode* node) {
+    long long sum = 0;
+    while (node != NULL) {
+        sum += node->data;
+        node = node->next;
+    }
+    return sum;
+}
+
+/*
+ * benchBuildMalloc: Builds, walks and frees a list of n nodes with malloc/free.
+ */
+void benchBuildMalloc(int n) {
+    double start = nowSeconds();
+    ListNode* head = NULL;
+    for (int i = 0; i < n; i++) {
+        ListNode* node = (ListNode*)malloc(sizeof(ListNode));
+        node->data = i;
+        node->next = head;
+        head = node;
+    }
+    double built = nowSeconds();
+    long long sum = sumList(head);
+    double walked = nowSeconds();
+    while (head != NULL) {
+        ListNode* next = head->next;
+        free(head);
+        head = next;
+    }
+    double freed = nowSeconds();
+    printf("  malloc : build %7.2f ms  walk %7.2f ms  free    %7.2f ms  (sum %lld)\n",
+           (built - start) * 1e3, (walked - built) * 1e3, (freed - walked) * 1e3, sum);
+}
+
+/*
+ * benchBuildPool: Builds and walks a list of n nodes from a pool, then releases the pool at once.
+ */
+void benchBuildPool(int n) {
+    NodePool pool;
+    poolInit(&pool, sizeof(ListNode), POOL_DEFAULT_SLAB_NODES);
+    double start = nowSeconds();
+    ListNode* head = NULL;
+    for (int i = 0; i < n; i++) {
+        ListNode* node = (ListNode*)poolAlloc(&pool);
+        node->data = i;
+        node->next = head;
+        head = node;
+    }
+    double built = nowSeconds();
+    long long sum = sumList(head);
+    double walked = nowSeconds();
+    poolReleaseAll(&pool);
+    double freed = nowSeconds();
+    printf("  pool   : build %7.2f ms  walk %7.2f ms  release %7.2f ms  (sum %lld)\n",
+           (built - start) * 1e3, (walked - built) * 1e3, (freed - walked) * 1e3, sum);
+    poolDestroy(&pool);
+}
+
+/*
+ * benchChurn: Replaces random live tree nodes n times, the pattern of insert/delete heavy use.
+ * Explanation: When pool is NULL the nodes come from malloc, otherwise from the pool.
+ */
+double benchChurn(NodePool* pool, int n) {
+    TreeNode* live[CHURN_LIVE];
+    unsigned int seed = 12345;
+    for (int i = 0; i < CHURN_LIVE; i++) {
+        live[i] = pool ? (TreeNode*)poolAlloc(pool) : (TreeNode*)malloc(sizeof(TreeNode));
+        live[i]->data = i;
+    }
+    double start = nowSeconds();
+    for (int i = 0; i < n; i++) {
+        int slot = nextRandom(&seed) % CHURN_LIVE;
+        if (pool) {
+            poolFree(pool, live[slot]);
+            live[slot] = (TreeNode*)poolAlloc(pool);
+        } else {
+            free(live[slot]);
+            live[slot] = (TreeNode*)malloc(sizeof(TreeNode));
+        }
+        live[slot]->data = i;
+    }
+    double elapsed = nowSeconds() - start;
+    for (int i = 0; i < CHURN_LIVE; i++) {
+        if (pool) poolFree(pool, live[i]);
+        else free(live[i]);
+    }
+    return elapsed;
+}
+
+// Arguments of one thread of the per-thread cache benchmark.
+typedef struct {
+    NodePool* pool;   // Shared pool, or NULL to use malloc.
+    int operations;   // Number of free/alloc pairs to perform.
+} ChurnArgs;
+
+/*
+ * churnThread: Thread body of the shared-pool benchmark.
+ * Explanation: Every thread keeps its own PoolCache, so it only takes the pool's lock once per batch.
+ */
+void* churnThread(void* arg) {
+    ChurnArgs* args = (ChurnArgs*)arg;
+    static _Thread_local PoolCache cache;
+    TreeNode* live[CHURN_LIVE];
+    unsigned int seed = 777;
+    if (args->pool) poolCacheInit(&cache, args->pool);
+    for (int i = 0; i < CHURN_LIVE; i++) {
+        live[i] = args->pool ? (TreeNode*)poolCacheAlloc(&cache) : (TreeNode*)malloc(sizeof(TreeNode));
+    }
+    for (int i = 0; i < args->operations; i++) {
+        int slot = nextRandom(&seed) % CHURN_LIVE;
+        if (args->pool) {
+            poolCacheFree(&cache, live[slot]);
+            live[slot] = (TreeNode*)poolCacheAlloc(&cache);
+        } else {
+            free(live[slot]);
+            live[slot] = (TreeNode*)malloc(sizeof(TreeNode));
+        }
+        live[slot]->data = i;
+    }
+    for (int i = 0; i < CHURN_LIVE; i++) {
+        if (args->pool) poolCacheFree(&cache, live[i]);
+        else free(live[i]);
+    }
+    if (args->pool) poolCacheFlush(&cache);
+    return NULL;
+}
+
+/*
+ * benchThreads: Runs churnThread on NUM_THREADS threads and returns the wall time.
+ */
+double benchThreads(NodePool* pool, int operations) {
+    pthread_t threads[NUM_THREADS];
+    ChurnArgs args = { pool, operations };
+    double start = nowSeconds();
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_create(&threads[i], NULL, churnThread, &args);
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return nowSeconds() - start;
+}
+
+// Main function to demonstrate the pool and compare it with malloc.
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (n <= 0) {
+        printf("Usage: %s [numNodes]\n", argv[0]);
+        return 1;
+    }
+
+    // Basic usage: allocate, free and reuse nodes.
+    NodePool pool;
+    poolInit(&pool, sizeof(ListNode), 4);
+    ListNode* a = (ListNode*)poolAlloc(&pool);
+    ListNode* b = (ListNode*)poolAlloc(&pool);
+    printf("Node size %zu bytes, pool stride %zu bytes, b - a = %td bytes\n",
+           sizeof(ListNode), pool.nodeSize, (char*)b - (char*)a);
+    poolFree(&pool, a);
+    ListNode* c = (ListNode*)poolAlloc(&pool);
+    printf("Freed node reused: %s, live nodes: %zu\n", c == a ? "yes" : "no", pool.liveNodes);
+    PoolCache cache;
+    poolCacheInit(&cache, &pool);
+    ListNode* d = (ListNode*)poolCacheAlloc(&cache);
+    size_t live = pool.liveNodes;
+    printf("One node from a cache: %zu more cached, live nodes %zu (%s)\n", cache.count, live,
+           live == 3 + cache.count ? "ok" : "FAILED");
+    poolCacheFree(&cache, d);
+    poolCacheFlush(&cache);
+    printf("After freeing it and flushing the cache: live nodes %zu (%s)\n\n", pool.liveNodes,
+           pool.liveNodes == 2 ? "ok" : "FAILED");
+    poolDestroy(&pool);
+
+    printf("Build/walk/teardown of a %d-node list:\n", n);
+    benchBuildMalloc(n);
+    benchBuildPool(n);
+
+    printf("\nChurn: %d random free+alloc pairs over %d live nodes:\n", n, CHURN_LIVE);
+    printf("  malloc : %7.2f ms\n", benchChurn(NULL, n) * 1e3);
+    poolInit(&pool, sizeof(TreeNode), POOL_DEFAULT_SLAB_NODES);
+    printf("  pool   : %7.2f ms\n", benchChurn(&pool, n) * 1e3);
+    poolDestroy(&pool);
+
+    printf("\nShared pool with per-thread caches, %d threads x %d pairs:\n", NUM_THREADS, n);
+    printf("  malloc : %7.2f ms\n", benchThreads(NULL, n) * 1e3);
+    poolInit(&pool, sizeof(TreeNode), POOL_DEFAULT_SLAB_NODES);
+    printf("  pool   : %7.2f ms\n", benchThreads(&pool, n) * 1e3);
+    printf("  live nodes after every cache is flushed: %zu (%s)\n",
+           pool.liveNodes, pool.liveNodes == 0 ? "ok" : "FAILED");
+    poolDestroy(&pool);
+
+    return 0;
+}
@@ -0,0 +1,493 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * 11-unrolledLinkedList.c: An unrolled (chunked) variant of the singly linked list in 02.
+ * Explanation: Every node holds a small array of values that fills one 64-byte cache line,
+ * so a traversal touches one cache line per UNROLLED_CAPACITY values instead of one per value.
+ * The list offers the same operations as 02 and benchmarks itself against it.
+ * Usage: ./unrolledLinkedList [numElements]
+ */
+
+#define CACHE_LINE 64
+// Number of ints that fit in a cache line next to the node header (13 on 64-bit systems).
+#define UNROLLED_CAPACITY ((CACHE_LINE - sizeof(void*) - sizeof(int)) / sizeof(int))
+
+// Unrolled list node: one cache line holding up to UNROLLED_CAPACITY values.
+typedef struct UNode {
+    struct UNode* next;               // Pointer to the next node.
+    int count;                        // Number of values used in this node.
+    int values[UNROLLED_CAPACITY];    // Values stored in order.
+} UNode;
+
+// Unrolled list handle: keeps both ends and the number of values, like the List in 02.
+typedef struct {
+    UNode* head;   // First node, NULL when the list is empty.
+    UNode* tail;   // Last node, NULL when the list is empty.
+    int size;      // Number of values (not nodes) in the list.
+} UnrolledList;
+
+/*
+ * createUNode: Allocates an empty cache-line-aligned node.
+ */
+UNode* createUNode(void) {
+    UNode* node = (UNode*)aligned_alloc(CACHE_LINE, sizeof(UNode));
+    if (node == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+/*
+ * initList: Sets up an empty list.
+ */
+void initList(UnrolledList* list) {
+    list->head = list->tail = NULL;
+    list->size = 0;
+}
+
+/*
+ * findNode: Finds the node that holds the value at the given index.
+ * Explanation: Whole nodes are skipped using their counts, so the walk takes
+ * index / UNROLLED_CAPACITY steps. The position inside the node is stored in *offset
+ * and the previous node (or NULL) in *prev.
+ */
+UNode* findNode(UnrolledList* list, int index, int* offset, UNode** prev) {
+    UNode* node = list->head;
+    UNode* before = NULL;
+    while (node != NULL && index >= node->count) {
+        index -= node->count;
+        before = node;
+        node = node->next;
+    }
+    *offset = index;
+    if (prev) *prev = before;
+    return node;
+}
+
+/*
+ * getAt: Returns the value at the given index (0-based).
+ * Explanation: Exits the program if the index is out of bounds.
+ */
+int getAt(UnrolledList* list, int index) {
+    if (index < 0 || index >= list->size) {
+        printf("Index %d out of bounds.\n", index);
+        exit(1);
+    }
+    int offset;
+    UNode* node = findNode(list, index, &offset, NULL);
+    return node->values[offset];
+}
+
+/*
+ * splitNode: Moves the upper half of a full node into a new node linked right after it.
+ */
+void splitNode(UnrolledList* list, UNode* node) {
+    UNode* newNode = createUNode();
+    int keep = node->count / 2;
+    newNode->count = node->count - keep;
+    memcpy(newNode->values, node->values + keep, newNode->count * sizeof(int));
+    node->count = keep;
+    newNode->next = node->next;
+    node->next = newNode;
+    if (list->tail == node) {
+        list->tail = newNode;
+    }
+}
+
+/*
+ * rebalanceNode: Brings a node that is below half full back to at least half full.
+ * Explanation: The successor is merged into the node when both fit in one node. Otherwise the
+ * successor holds more than half a node, and values move from its front until the two are even.
+ * The last node has no successor and is the one node allowed to be less than half full.
+ */
+void rebalanceNode(UnrolledList* list, UNode* node) {
+    UNode* next = node->next;
+    if (next == NULL || node->count >= (int)UNROLLED_CAPACITY / 2) return;
+    if (node->count + next->count <= (int)UNROLLED_CAPACITY) {
+        // Merge the successor into this node.
+        memcpy(node->values + node->count, next->values, next->count * sizeof(int));
+        node->count += next->count;
+        node->next = next->next;
+        if (list->tail == next) list->tail = node;
+        free(next);
+        return;
+    }
+    // Borrow from the successor.
+    int moved = (next->count - node->count) / 2;
+    memcpy(node->values + node->count, next->values, moved * sizeof(int));
+    memmove(next->values, next->values + moved, (next->count - moved) * sizeof(int));
+    node->count += moved;
+    next->count -= moved;
+}
+
+/*
+ * insertAt: Inserts a value so that it ends up at the given position (0..size).
+ * Explanation: The value is shifted into its node with memmove. A full node is split in half
+ * first, so both halves are at least half full.
+ */
+void insertAt(UnrolledList* list, int value, int index) {
+    if (index < 0 || index > list->size)
+        return; // Index out of bounds, do nothing
+    if (list->head == NULL) {
+        list->head = list->tail = createUNode();
+    }
+    int offset;
+    UNode* node;
+    if (index == list->size) {
+        // Appending goes into the tail, which keeps appended nodes completely full.
+        node = list->tail;
+        offset = node->count;
+    } else {
+        node = findNode(list, index, &offset, NULL);
+    }
+    if (node->count == (int)UNROLLED_CAPACITY) {
+        if (node == list->tail && offset == node->count) {
+            // Appending to a full tail: start a new node instead of splitting.
+            node->next = createUNode();
+            list->tail = node = node->next;
+            offset = 0;
+        } else {
+            splitNode(list, node);
+            if (offset > node->count) {
+                offset -= node->count;
+                node = node->next;
+            }
+        }
+    }
+    memmove(node->values + offset + 1, node->values + offset, (node->count - offset) * sizeof(int));
+    node->values[offset] = value;
+    node->count++;
+    list->size++;
+}
+
+/*
+ * insertAtBeginning: Inserts a value at the front of the list.
+ */
+void insertAtBeginning(UnrolledList* list, int value) {
+    insertAt(list, value, 0);
+}
+
+/*
+ * insertAtEnd: Appends a value to the end of the list in O(1).
+ */
+void insertAtEnd(UnrolledList* list, int value) {
+    insertAt(list, value, list->size);
+}
+
+/*
+ * insertAfterIndex: Same convention as insertAfterIndex in 02: the new value ends up at position index.
+ */
+void insertAfterIndex(UnrolledList* list, int value, int index) {
+    insertAt(list, value, index);
+}
+
+/*
+ * deleteAtIndex: Deletes the value at the given index (0-based).
+ * Explanation: The value is removed with memmove. An emptied node is unlinked, and a node
+ * that drops below half full is rebalanced with its successor, so every node but the last stays
+ * at least half full.
+ */
+void deleteAtIndex(UnrolledList* list, int index) {
+    if (index < 0 || index >= list->size) return; // Index out of bounds
+    int offset;
+    UNode* prev;
+    UNode* node = findNode(list, index, &offset, &prev);
+    memmove(node->values + offset, node->values + offset + 1, (node->count - offset - 1) * sizeof(int));
+    node->count--;
+    list->size--;
+
+    if (node->count == 0) {
+        // Unlink the empty node.
+        if (prev) prev->next = node->next;
+        else list->head = node->next;
+        if (list->tail == node) list->tail = prev;
+        free(node);
+        return;
+    }
+    rebalanceNode(list, node);
+}
+
+/*
+ * deleteFromBeginning: Deletes the first value.
+ */
+void deleteFromBeginning(UnrolledList* list) {
+    deleteAtIndex(list, 0);
+}
+
+/*
+ * deleteFromEnd: Deletes the last value.
+ */
+void deleteFromEnd(UnrolledList* list) {
+    deleteAtIndex(list, list->size - 1);
+}
+
+/*
+ * reverseList: Reverses the list.
+ * Explanation: The order of the nodes is reversed like in 02, and the values inside each node are reversed in place.
+ * The old last node, which may be less than half full, becomes the first one and is rebalanced.
+ */
+void reverseList(UnrolledList* list) {
+    UNode* prev = NULL;
+    UNode* current = list->head;
+    list->tail = current;
+    while (current != NULL) {
+        for (int i = 0, j = current->count - 1; i < j; i++, j--) {
+            int temp = current->values[i];
+            current->values[i] = current->values[j];
+            current->values[j] = temp;
+        }
+        UNode* nextNode = current->next;
+        current->next = prev;
+        prev = current;
+        current = nextNode;
+    }
+    list->head = prev;
+    if (prev != NULL) rebalanceNode(list, prev);
+}
+
+/*
+ * deleteList: Releases every node and leaves the list empty.
+ */
+void deleteList(UnrolledList* list) {
+    UNode* node = list->head;
+    while (node != NULL) {
+        UNode* next = node->next;
+        free(node);
+        node = next;
+    }
+    initList(list);
+}
+
+/*
+ * printList: Prints the values, with '|' marking node boundaries.
+ */
+void printList(UnrolledList* list) {
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        printf("[");
+        for (int i = 0; i < node->count; i++) {
+            printf(i ? " %d" : "%d", node->values[i]);
+        }
+        printf("] -> ");
+    }
+    printf("NULL\n");
+}
+
+/*
+ * sumList: Adds up all values; the inner loop runs over a contiguous array.
+ */
+long long sumList(UnrolledList* list) {
+    long long sum = 0;
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        for (int i = 0; i < node->count; i++) {
+            sum += node->values[i];
+        }
+    }
+    return sum;
+}
+
+/*
+ * Pointer-per-int list from 02, reduced to what the benchmark needs.
+ */
+struct Node {
+    int data;
+    struct Node* next;
+};
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * benchmark: Compares traversal and indexed access of both lists holding the same n values.
+ */
+void benchmark(int n) {
+    const int reps = 20;          // Full traversals timed.
+    const int lookups = 2000;     // Random indexed accesses timed.
+    unsigned int seed = 1;
+
+    // Build both lists with n appends.
+    UnrolledList ulist;
+    initList(&ulist);
+    struct Node* head = NULL;
+    struct Node* tail = NULL;
+    for (int i = 0; i < n; i++) {
+        insertAtEnd(&ulist, i);
+        struct Node* node = (struct Node*)malloc(sizeof(struct Node));
+        node->data = i;
+        node->next = NULL;
+        if (tail) tail->next = node;
+        else head = node;
+        tail = node;
+    }
+
+    int nodes = 0;
+    for (UNode* node = ulist.head; node != NULL; node = node->next) nodes++;
+    printf("Memory: pointer list %zu bytes/value, unrolled list %.2f bytes/value (%d nodes of %zu values)\n",
+           sizeof(struct Node), (double)nodes * sizeof(UNode) / n, nodes, UNROLLED_CAPACITY);
+
+    // Traversal.
+    long long sumA = 0, sumB = 0;
+    double start = nowSeconds();
+    for (int r = 0; r < reps; r++) {
+        for (struct Node* node = head; node != NULL; node = node->next) sumA += node->data;
+    }
+    double pointerTime = nowSeconds() - start;
+    start = nowSeconds();
+    for (int r = 0; r < reps; r++) sumB += sumList(&ulist);
+    double unrolledTime = nowSeconds() - start;
+    printf("Traversal x%-10d pointer %8.2f ms   unrolled %8.2f ms   (%s)\n",
+           reps, pointerTime * 1e3, unrolledTime * 1e3, sumA == sumB ? "sums match" : "SUMS DIFFER");
+
+    // Indexed access.
+    sumA = sumB = 0;
+    start = nowSeconds();
+    for (int k = 0; k < lookups; k++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)n);
+        struct Node* node = head;
+        for (int i = 0; i < index; i++) node = node->next;
+        sumA += node->data;
+    }
+    pointerTime = nowSeconds() - start;
+    seed = 1;
+    start = nowSeconds();
+    for (int k = 0; k < lookups; k++) {
+        seed = seed * 1103515245u + 12345u;
+        sumB += getAt(&ulist, (int)((seed >> 8) % (unsigned int)n));
+    }
+    unrolledTime = nowSeconds() - start;
+    printf("Indexed access x%-5d pointer %8.2f ms   unrolled %8.2f ms   (%s)\n",
+           lookups, pointerTime * 1e3, unrolledTime * 1e3, sumA == sumB ? "sums match" : "SUMS DIFFER");
+
+    while (head != NULL) {
+        struct Node* next = head->next;
+        free(head);
+        head = next;
+    }
+    deleteList(&ulist);
+}
+
+/*
+ * checkList: Returns 1 if the list holds exactly expected[0..n-1] and every node but the last
+ * is at least half full.
+ */
+int checkList(UnrolledList* list, const int* expected, int n) {
+    int i = 0;
+    for (UNode* node = list->head; node != NULL; node = node->next) {
+        if (node->count == 0 || (node != list->tail && node->count < (int)UNROLLED_CAPACITY / 2))
+            return 0;
+        if (node->next == NULL && node != list->tail) return 0;
+        for (int k = 0; k < node->count; k++) {
+            if (i >= n || node->values[k] != expected[i++]) return 0;
+        }
+    }
+    return i == n && list->size == n;
+}
+
+/*
+ * checkRandomOperations: Runs random inserts, deletes and reversals against a plain array and
+ * checks the list after every step.
+ */
+int checkRandomOperations(void) {
+    enum { STEPS = 20000, MAX_VALUES = 400 };
+    int expected[MAX_VALUES];
+    int n = 0;
+    unsigned int seed = 7;
+    UnrolledList list;
+    initList(&list);
+    for (int step = 0; step < STEPS; step++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int r = seed >> 8;
+        if (r % 50 == 0) {
+            reverseList(&list);
+            for (int i = 0, j = n - 1; i < j; i++, j--) {
+                int temp = expected[i];
+                expected[i] = expected[j];
+                expected[j] = temp;
+            }
+        } else if (n < MAX_VALUES && (n == 0 || r % 2 == 0)) {
+            int index = (int)((r >> 8) % (unsigned int)(n + 1));
+            insertAt(&list, step, index);
+            memmove(expected + index + 1, expected + index, (n - index) * sizeof(int));
+            expected[index] = step;
+            n++;
+        } else {
+            int index = (int)((r >> 8) % (unsigned int)n);
+            deleteAtIndex(&list, index);
+            memmove(expected + index, expected + index + 1, (n - index - 1) * sizeof(int));
+            n--;
+        }
+        if (!checkList(&list, expected, n)) {
+            deleteList(&list);
+            return 0;
+        }
+    }
+    deleteList(&list);
+    return 1;
+}
+
+// Main function to demonstrate the unrolled list and compare it with the list from 02.
+int main(int argc, char* argv[]) {
+    UnrolledList list;
+    initList(&list);
+
+    // Same sequence of operations as the demo in 02.
+    printf("Initial list:\n");
+    insertAtEnd(&list, 10);
+    insertAtEnd(&list, 20);
+    insertAtEnd(&list, 30);
+    printList(&list);
+
+    printf("\nInsert 5 at the beginning:\n");
+    insertAtBeginning(&list, 5);
+    printList(&list);
+
+    printf("\nAppend 40 to the list:\n");
+    insertAtEnd(&list, 40);
+    printList(&list);
+
+    printf("\nInsert 25 after index 1:\n");
+    insertAfterIndex(&list, 25, 2);
+    printList(&list);
+
+    printf("\nDelete from the beginning:\n");
+    deleteFromBeginning(&list);
+    printList(&list);
+
+    printf("\nDelete node at index 2:\n");
+    deleteAtIndex(&list, 2);
+    printList(&list);
+
+    printf("\nDelete from the end:\n");
+    deleteFromEnd(&list);
+    printList(&list);
+
+    printf("\nReverse the list:\n");
+    reverseList(&list);
+    printList(&list);
+
+    // A longer list shows how values are packed into nodes.
+    printf("\nAppend 1..30:\n");
+    for (int i = 1; i <= 30; i++) insertAtEnd(&list, i);
+    printList(&list);
+    printf("Value at index 17: %d\n", getAt(&list, 17));
+    deleteList(&list);
+
+    printf("\nRandom inserts, deletes and reversals keep every node but the last half full: %s\n",
+           checkRandomOperations() ? "ok" : "FAILED");
+
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    if (n > 0) {
+        printf("\nBenchmark with %d values:\n", n);
+        benchmark(n);
+    }
+    return 0;
+}
@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * 12-indexableSkipList.c: The doubly linked list from 03 with a positional index on top.
+ * Explanation: Level 0 of the skip list is an ordinary doubly linked list (prev/next), so walking
+ * the list is exactly as cheap as in 03. Some nodes also take part in higher levels, whose links
+ * skip over many nodes at once. Every link stores its span (how many positions it skips), which
+ * lets getAt, insertAfterIndex and deleteAtIndex find a position in O(log n) expected time.
+ * Usage: ./indexableSkipList [numElements]
+ */
+
+#define MAX_LEVEL 32      // Enough levels for 4^32 elements.
+#define LEVEL_CHANCE 4    // A node reaches the next level with probability 1/LEVEL_CHANCE.
+
+// One forward link of a node at some level.
+typedef struct SkipLink {
+    struct Node* next;    // Next node at this level, NULL at the end.
+    int span;             // Number of positions this link moves forward.
+} SkipLink;
+
+// Skip list node: a doubly linked node followed by its forward links.
+typedef struct Node {
+    int data;             // Data stored in the node.
+    int level;            // Number of levels this node takes part in.
+    struct Node* prev;    // Pointer to the previous node (level 0), NULL for the first node.
+    SkipLink links[];     // links[0].next is the next node; higher levels skip further.
+} Node;
+
+// Skip list handle.
+typedef struct {
+    Node* header;         // Sentinel with MAX_LEVEL links; not part of the data.
+    Node* tail;           // Last node, NULL when the list is empty.
+    int level;            // Number of levels currently in use.
+    int size;             // Number of nodes in the list.
+    unsigned int seed;    // State of the level generator.
+} SkipList;
+
+/*
+ * next: Returns the node after the given one, the same single pointer load as node->next in 03.
+ */
+static inline Node* next(Node* node) {
+    return node->links[0].next;
+}
+
+/*
+ * createNode: Allocates a node with room for the given number of levels.
+ */
+Node* createNode(int data, int level) {
+    Node* newNode = (Node*)malloc(sizeof(Node) + level * sizeof(SkipLink));
+    if (newNode == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    newNode->data = data;
+    newNode->level = level;
+    newNode->prev = NULL;
+    for (int i = 0; i < level; i++) {
+        newNode->links[i].next = NULL;
+        newNode->links[i].span = 0;
+    }
+    return newNode;
+}
+
+/*
+ * initList: Creates the sentinel and sets up an empty list.
+ */
+void initList(SkipList* list) {
+    list->header = createNode(0, MAX_LEVEL);
+    list->tail = NULL;
+    list->level = 1;
+    list->size = 0;
+    list->seed = 2463534242u;
+}
+
+/*
+ * randomLevel: Picks the number of levels for a new node.
+ * Explanation: Each extra level is taken with probability 1/LEVEL_CHANCE, so on average
+ * a node has 4/3 links and each level is four times sparser than the one below.
+ */
+int randomLevel(SkipList* list) {
+    int level = 1;
+    while (level < MAX_LEVEL) {
+        unsigned int x = list->seed;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        list->seed = x;
+        if (x % LEVEL_CHANCE != 0) break;
+        level++;
+    }
+    return level;
+}
+
+/*
+ * findPredecessors: Finds, on every level, the last node before position index.
+ * Explanation: Starting at the top level, the search follows a link as long as its span does
+ * not move past the target. update[i] receives the predecessor on level i and rank[i] its
+ * position (the header has position 0, the first node position 1).
+ */
+void findPredecessors(SkipList* list, int index, Node* update[], int rank[]) {
+    Node* x = list->header;
+    int position = 0;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->links[i].next != NULL && position + x->links[i].span <= index) {
+            position += x->links[i].span;
+            x = x->links[i].next;
+        }
+        update[i] = x;
+        rank[i] = position;
+    }
+}
+
+/*
+ * getNode: Returns the node at the given index (0-based) or NULL when out of bounds.
+ */
+Node* getNode(SkipList* list, int index) {
+    if (index < 0 || index >= list->size) return NULL;
+    Node* x = list->header;
+    int position = 0;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->links[i].next != NULL && position + x->links[i].span <= index + 1) {
+            position += x->links[i].span;
+            x = x->links[i].next;
+        }
+        if (position == index + 1) return x;
+    }
+    return NULL;
+}
+
+/*
+ * getAt: Returns the value at the given index (0-based).
+ * Explanation: Exits the program if the index is out of bounds.
+ */
+int getAt(SkipList* list, int index) {
+    Node* node = getNode(list, index);
+    if (node == NULL) {
+        printf("Index %d out of bounds.\n", index);
+        exit(1);
+    }
+    return node->data;
+}
+
+/*
+ * insertAt: Inserts a value so that it ends up at the given position (0..size).
+ * Explanation: The new node is linked after its predecessor on each of its levels; the spans of
+ * the links it splits are divided between the predecessor and the new node, and links on higher
+ * levels that now skip over it grow by one.
+ */
+void insertAt(SkipList* list, int data, int index) {
+    if (index < 0 || index > list->size) return; // Index out of bounds, do nothing
+    Node* update[MAX_LEVEL];
+    int rank[MAX_LEVEL];
+    findPredecessors(list, index, update, rank);
+
+    int level = randomLevel(list);
+    if (level > list->level) {
+        // New levels start at the header and span the whole list.
+        for (int i = list->level; i < level; i++) {
+            update[i] = list->header;
+            rank[i] = 0;
+            list->header->links[i].span = list->size;
+        }
+        list->level = level;
+    }
+
+    Node* newNode = createNode(data, level);
+    for (int i = 0; i < level; i++) {
+        newNode->links[i].next = update[i]->links[i].next;
+        newNode->links[i].span = update[i]->links[i].span - (rank[0] - rank[i]);
+        update[i]->links[i].next = newNode;
+        update[i]->links[i].span = (rank[0] - rank[i]) + 1;
+    }
+    for (int i = level; i < list->level; i++) {
+        update[i]->links[i].span++; // These links now skip over the new node.
+    }
+
+    // Level 0 is the doubly linked list.
+    newNode->prev = update[0] == list->header ? NULL : update[0];
+    if (next(newNode) != NULL) {
+        next(newNode)->prev = newNode;
+    } else {
+        list->tail = newNode;
+    }
+    list->size++;
+}
+
+/*
+ * deleteAtIndex: Deletes the node at the given index (0-based).
+ * Explanation: The node is unlinked on every level it takes part in; links that skipped over it shrink by one.
+ */
+void deleteAtIndex(SkipList* list, int index) {
+    if (index < 0 || index >= list->size) return; // Index out of bounds, do nothing
+    Node* update[MAX_LEVEL];
+    int rank[MAX_LEVEL];
+    findPredecessors(list, index, update, rank);
+    Node* target = next(update[0]);
+
+    for (int i = 0; i < list->level; i++) {
+        if (update[i]->links[i].next == target) {
+            update[i]->links[i].span += target->links[i].span - 1;
+            update[i]->links[i].next = target->links[i].next;
+        } else {
+            update[i]->links[i].span--;
+        }
+    }
+    if (next(target) != NULL) {
+        next(target)->prev = target->prev;
+    } else {
+        list->tail = target->prev;
+    }
+    while (list->level > 1 && list->header->links[list->level - 1].next == NULL) {
+        list->level--; // Drop levels that became empty.
+    }
+    free(target);
+    list->size--;
+}
+
+/*
+ * insertAtBeginning: Inserts a value at the front of the list.
+ */
+void insertAtBeginning(SkipList* list, int data) {
+    insertAt(list, data, 0);
+}
+
+/*
+ * insertAtEnd: Appends a value to the end of the list.
+ */
+void insertAtEnd(SkipList* list, int data) {
+    insertAt(list, data, list->size);
+}
+
+/*
+ * insertAfterIndex: Same convention as insertAfterIndex in 03: the new value ends up at position index.
+ */
+void insertAfterIndex(SkipList* list, int data, int index) {
+    insertAt(list, data, index);
+}
+
+/*
+ * deleteFromBeginning: Deletes the first node.
+ */
+void deleteFromBeginning(SkipList* list) {
+    deleteAtIndex(list, 0);
+}
+
+/*
+ * deleteFromEnd: Deletes the last node.
+ */
+void deleteFromEnd(SkipList* list) {
+    deleteAtIndex(list, list->size - 1);
+}
+
+/*
+ * deleteList: Releases every node, including the sentinel.
+ */
+void deleteList(SkipList* list) {
+    Node* node = list->header;
+    while (node != NULL) {
+        Node* nextNode = next(node);
+        free(node);
+        node = nextNode;
+    }
+    list->header = list->tail = NULL;
+    list->size = 0;
+}
+
+/*
+ * printList: Prints the list from the first node to the last using next pointers.
+ */
+void printList(SkipList* list) {
+    for (Node* node = next(list->header); node != NULL; node = next(node)) {
+        printf("%d -> ", node->data);
+    }
+    printf("NULL\n");
+}
+
+/*
+ * printListBackward: Prints the list from the last node to the first using prev pointers.
+ */
+void printListBackward(SkipList* list) {
+    for (Node* node = list->tail; node != NULL; node = node->prev) {
+        printf("%d -> ", node->data);
+    }
+    printf("NULL\n");
+}
+
+/*
+ * Doubly linked list from 03, reduced to what the benchmark needs.
+ */
+typedef struct DNode {
+    int data;
+    struct DNode* next;
+    struct DNode* prev;
+} DNode;
+
+// Walks to the node at index, starting from whichever end is closer (like nodeAt in 03).
+DNode* dnodeAt(DNode* head, DNode* tail, int size, int index) {
+    DNode* temp;
+    if (index < size / 2) {
+        temp = head;
+        for (int i = 0; i < index; i++) temp = temp->next;
+    } else {
+        temp = tail;
+        for (int i = size - 1; i > index; i--) temp = temp->prev;
+    }
+    return temp;
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * benchmark: Builds both lists with n random positional inserts, then reads n/10 random indices.
+ */
+void benchmark(int n) {
+    unsigned int seed = 42;
+
+    // Skip list.
+    SkipList list;
+    initList(&list);
+    double start = nowSeconds();
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        insertAt(&list, i, (int)((seed >> 8) % (unsigned int)(list.size + 1)));
+    }
+    long long sumSkip = 0;
+    for (int i = 0; i < n / 10; i++) {
+        seed = seed * 1103515245u + 12345u;
+        sumSkip += getAt(&list, (int)((seed >> 8) % (unsigned int)list.size));
+    }
+    double skipTime = nowSeconds() - start;
+
+    // Plain doubly linked list with the same sequence of positions.
+    seed = 42;
+    DNode* head = NULL;
+    DNode* tail = NULL;
+    int size = 0;
+    start = nowSeconds();
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)(size + 1));
+        DNode* node = (DNode*)malloc(sizeof(DNode));
+        node->data = i;
+        DNode* after = index == size ? NULL : dnodeAt(head, tail, size, index);
+        DNode* before = after ? after->prev : tail;
+        node->next = after;
+        node->prev = before;
+        if (before) before->next = node; else head = node;
+        if (after) after->prev = node; else tail = node;
+        size++;
+    }
+    long long sumPlain = 0;
+    for (int i = 0; i < n / 10; i++) {
+        seed = seed * 1103515245u + 12345u;
+        sumPlain += dnodeAt(head, tail, size, (int)((seed >> 8) % (unsigned int)size))->data;
+    }
+    double plainTime = nowSeconds() - start;
+
+    printf("%d positional inserts + %d indexed reads: doubly linked %8.2f ms, skip list %8.2f ms (%s)\n",
+           n, n / 10, plainTime * 1e3, skipTime * 1e3, sumSkip == sumPlain ? "results match" : "RESULTS DIFFER");
+
+    while (head != NULL) {
+        DNode* nextNode = head->next;
+        free(head);
+        head = nextNode;
+    }
+    deleteList(&list);
+}
+
+// Main function to demonstrate the indexable skip list.
+int main(int argc, char* argv[]) {
+    SkipList list;
+    initList(&list);
+
+    // Same sequence of operations as the demo in 03.
+    printf("Initial list:\n");
+    insertAtEnd(&list, 10);
+    insertAtEnd(&list, 20);
+    insertAtEnd(&list, 30);
+    printList(&list);
+
+    printf("\nInsert 5 at the beginning:\n");
+    insertAtBeginning(&list, 5);
+    printList(&list);
+
+    printf("\nInsert 40 at the end:\n");
+    insertAtEnd(&list, 40);
+    printList(&list);
+
+    printf("\nInsert 25 after index 1:\n");
+    insertAfterIndex(&list, 25, 2);
+    printList(&list);
+
+    printf("\nDelete from the beginning:\n");
+    deleteFromBeginning(&list);
+    printList(&list);
+
+    printf("\nDelete node at index 2:\n");
+    deleteAtIndex(&list, 2);
+    printList(&list);
+
+    printf("\nDelete from the end:\n");
+    deleteFromEnd(&list);
+    printList(&list);
+
+    printf("\nBackward traversal through prev pointers:\n");
+    printListBackward(&list);
+    printf("Value at index 1: %d\n", getAt(&list, 1));
+    deleteList(&list);
+
+    int n = argc > 1 ? atoi(argv[1]) : 20000;
+    if (n > 0) {
+        printf("\n");
+        benchmark(n);
+    }
+    return 0;
+}
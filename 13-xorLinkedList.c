@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * 13-xorLinkedList.c: A memory-compact mode for the doubly linked list from 03.
+ * Explanation: Instead of a next and a prev pointer, each node stores one link field that holds
+ * (index of prev) XOR (index of next). Nodes live in one growable array (the pool) and are
+ * addressed by 32-bit indices, so a node with an int payload takes 8 bytes instead of 24.
+ * Knowing the node you came from is enough to find the next one in either direction, and
+ * reversing the list only swaps its two ends.
+ */
+
+#define NIL 0u  // Index 0 of the pool is reserved and means "no node".
+
+// Compact node: 4-byte payload and one 4-byte XOR link.
+typedef struct {
+    int data;        // Data stored in the node.
+    uint32_t link;   // Index of the previous node XOR index of the next node.
+} XNode;
+
+// XOR list handle: the node pool plus both ends of the list.
+typedef struct {
+    XNode* nodes;      // Node pool; nodes[0] is unused so that index 0 can mean NIL.
+    uint32_t capacity; // Number of slots in the pool.
+    uint32_t used;     // Slots handed out so far (including slot 0).
+    uint32_t freeList; // Released slots, chained through their link field.
+    uint32_t head;     // Index of the first node, NIL when empty.
+    uint32_t tail;     // Index of the last node, NIL when empty.
+    int size;          // Number of nodes in the list.
+} XorList;
+
+// Iterator for walking the list in either direction.
+typedef struct {
+    uint32_t prev;     // Node visited before the current one.
+    uint32_t current;  // Current node, NIL when the walk is finished.
+} XorIterator;
+
+/*
+ * initList: Sets up an empty list with a small pool.
+ */
+void initList(XorList* list) {
+    list->capacity = 16;
+    list->nodes = (XNode*)malloc(list->capacity * sizeof(XNode));
+    if (list->nodes == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    list->used = 1; // Slot 0 is NIL.
+    list->freeList = NIL;
+    list->head = list->tail = NIL;
+    list->size = 0;
+}
+
+/*
+ * createNode: Takes a slot from the pool, doubling the pool when it is full.
+ * Explanation: Indices stay valid when the pool is moved by realloc, unlike pointers.
+ */
+uint32_t createNode(XorList* list, int data) {
+    uint32_t index;
+    if (list->freeList != NIL) {
+        index = list->freeList;
+        list->freeList = list->nodes[index].link;
+    } else {
+        if (list->used == list->capacity) {
+            if (list->capacity > UINT32_MAX / 2) {
+                printf("List is too large.\n");
+                exit(1);
+            }
+            list->capacity *= 2;
+            XNode* nodes = (XNode*)realloc(list->nodes, list->capacity * sizeof(XNode));
+            if (nodes == NULL) {
+                printf("Memory allocation failed.\n");
+                exit(1);
+            }
+            list->nodes = nodes;
+        }
+        index = list->used++;
+    }
+    list->nodes[index].data = data;
+    list->nodes[index].link = NIL;
+    return index;
+}
+
+/*
+ * freeNode: Returns a slot to the pool's free list.
+ */
+void freeNode(XorList* list, uint32_t index) {
+    list->nodes[index].link = list->freeList;
+    list->freeList = index;
+}
+
+/*
+ * begin / rbegin: Iterators starting at the head (forward) or the tail (backward).
+ */
+XorIterator begin(XorList* list) {
+    XorIterator it = { NIL, list->head };
+    return it;
+}
+
+XorIterator rbegin(XorList* list) {
+    XorIterator it = { NIL, list->tail };
+    return it;
+}
+
+/*
+ * advance: Moves an iterator one node further in the direction it is walking.
+ * Explanation: link = prev ^ next, so next = link ^ prev.
+ */
+void advance(XorList* list, XorIterator* it) {
+    uint32_t nextIndex = list->nodes[it->current].link ^ it->prev;
+    it->prev = it->current;
+    it->current = nextIndex;
+}
+
+/*
+ * iteratorAt: Returns a forward iterator whose current node is at the given index (0..size-1).
+ * Explanation: Like nodeAt in 03, the walk starts from whichever end is closer. A backward walk
+ * ends with prev holding the node after current; the node before it is then link ^ prev.
+ */
+XorIterator iteratorAt(XorList* list, int index) {
+    XorIterator it;
+    if (index < list->size / 2) {
+        it = begin(list);                          // Walk forward from the head
+        for (int i = 0; i < index; i++) {
+            advance(list, &it);
+        }
+    } else {
+        it = rbegin(list);                         // Walk backward from the tail
+        for (int i = list->size - 1; i > index; i--) {
+            advance(list, &it);
+        }
+        it.prev = list->nodes[it.current].link ^ it.prev;  // Turn it around to face forward
+    }
+    return it;
+}
+
+/*
+ * insertAtBeginning: Inserts a node in front of the head.
+ */
+void insertAtBeginning(XorList* list, int data) {
+    uint32_t newNode = createNode(list, data);
+    list->nodes[newNode].link = list->head;        // prev is NIL, next is the old head
+    if (list->head == NIL) {
+        list->tail = newNode;
+    } else {
+        list->nodes[list->head].link ^= newNode;   // The old head's prev changes from NIL to newNode
+    }
+    list->head = newNode;
+    list->size++;
+}
+
+/*
+ * insertAtEnd: Appends a node after the tail.
+ */
+void insertAtEnd(XorList* list, int data) {
+    uint32_t newNode = createNode(list, data);
+    list->nodes[newNode].link = list->tail;        // prev is the old tail, next is NIL
+    if (list->tail == NIL) {
+        list->head = newNode;
+    } else {
+        list->nodes[list->tail].link ^= newNode;   // The old tail's next changes from NIL to newNode
+    }
+    list->tail = newNode;
+    list->size++;
+}
+
+/*
+ * insertAfterIndex: Same convention as insertAfterIndex in 03: the new node ends up at position index.
+ */
+void insertAfterIndex(XorList* list, int data, int index) {
+    if (index < 0 || index > list->size) return; // Index out of bounds, do nothing
+    if (index == 0) {
+        insertAtBeginning(list, data);
+        return;
+    }
+    if (index == list->size) {
+        insertAtEnd(list, data);
+        return;
+    }
+    XorIterator it = iteratorAt(list, index);
+    // Insert between it.prev and it.current.
+    uint32_t newNode = createNode(list, data);
+    list->nodes[newNode].link = it.prev ^ it.current;
+    list->nodes[it.prev].link ^= it.current ^ newNode;     // prev's next: current -> newNode
+    list->nodes[it.current].link ^= it.prev ^ newNode;     // current's prev: prev -> newNode
+    list->size++;
+}
+
+/*
+ * deleteAtIndex: Deletes the node at the given index (0-based).
+ */
+void deleteAtIndex(XorList* list, int index) {
+    if (index < 0 || index >= list->size) return; // Index out of bounds, do nothing
+    XorIterator it = iteratorAt(list, index);
+    uint32_t target = it.current;
+    uint32_t prevIndex = it.prev;
+    uint32_t nextIndex = list->nodes[target].link ^ prevIndex;
+    if (prevIndex != NIL) list->nodes[prevIndex].link ^= target ^ nextIndex;
+    else list->head = nextIndex;
+    if (nextIndex != NIL) list->nodes[nextIndex].link ^= target ^ prevIndex;
+    else list->tail = prevIndex;
+    freeNode(list, target);
+    list->size--;
+}
+
+/*
+ * deleteFromBeginning: Deletes the head in O(1).
+ */
+void deleteFromBeginning(XorList* list) {
+    deleteAtIndex(list, 0);
+}
+
+/*
+ * deleteFromEnd: Deletes the tail in O(1).
+ * Explanation: The tail's link holds only its prev index, which becomes the new tail.
+ */
+void deleteFromEnd(XorList* list) {
+    if (list->tail == NIL) return;
+    uint32_t target = list->tail;
+    uint32_t prevIndex = list->nodes[target].link;
+    if (prevIndex != NIL) list->nodes[prevIndex].link ^= target;
+    else list->head = NIL;
+    list->tail = prevIndex;
+    freeNode(list, target);
+    list->size--;
+}
+
+/*
+ * reverseList: Reverses the list in O(1).
+ * Explanation: The XOR link is symmetric, so no node has to change; swapping head and tail is enough.
+ */
+void reverseList(XorList* list) {
+    uint32_t temp = list->head;
+    list->head = list->tail;
+    list->tail = temp;
+}
+
+/*
+ * deleteList: Releases the pool.
+ */
+void deleteList(XorList* list) {
+    free(list->nodes);
+    list->nodes = NULL;
+    list->capacity = list->used = 0;
+    list->freeList = list->head = list->tail = NIL;
+    list->size = 0;
+}
+
+/*
+ * printList: Prints the list from head to tail.
+ */
+void printList(XorList* list) {
+    for (XorIterator it = begin(list); it.current != NIL; advance(list, &it)) {
+        printf("%d -> ", list->nodes[it.current].data);
+    }
+    printf("NULL\n");
+}
+
+/*
+ * printListBackward: Prints the list from tail to head with the same advance step.
+ */
+void printListBackward(XorList* list) {
+    for (XorIterator it = rbegin(list); it.current != NIL; advance(list, &it)) {
+        printf("%d -> ", list->nodes[it.current].data);
+    }
+    printf("NULL\n");
+}
+
+// Layout of a node in 03, used for the memory report.
+struct Node {
+    int data;
+    struct Node* next;
+    struct Node* prev;
+};
+
+/*
+ * reportMemory: Compares memory per element of both layouts for a list of n elements.
+ */
+void reportMemory(int n) {
+    XorList list;
+    initList(&list);
+    for (int i = 0; i < n; i++) {
+        insertAtEnd(&list, i);
+    }
+    // malloc adds a header to every small block and rounds it up to 16 bytes (glibc on 64-bit).
+    size_t mallocBlock = (sizeof(struct Node) + sizeof(size_t) + 15) / 16 * 16;
+    printf("Memory per element for %d elements:\n", n);
+    printf("  03 layout:  %zu bytes/node (%zu bytes with malloc overhead)\n", sizeof(struct Node), mallocBlock);
+    printf("  XOR layout: %zu bytes/node (%.2f bytes with pool slack, %u slots)\n",
+           sizeof(XNode), (double)list.capacity * sizeof(XNode) / n, list.capacity);
+    deleteList(&list);
+}
+
+/*
+ * checkList: Returns 1 if walking the list forward and backward gives exactly expected[0..n-1].
+ */
+int checkList(XorList* list, const int* expected, int n) {
+    if (list->size != n) return 0;
+    XorIterator it = begin(list);
+    for (int i = 0; i < n; i++) {
+        if (it.current == NIL || list->nodes[it.current].data != expected[i]) return 0;
+        advance(list, &it);
+    }
+    if (it.current != NIL) return 0;
+    it = rbegin(list);
+    for (int i = n - 1; i >= 0; i--) {
+        if (it.current == NIL || list->nodes[it.current].data != expected[i]) return 0;
+        advance(list, &it);
+    }
+    return it.current == NIL;
+}
+
+/*
+ * checkRandomOperations: Runs random indexed inserts and deletes (walking from either end) and
+ * reversals against a plain array and checks the list after every step.
+ */
+int checkRandomOperations(void) {
+    enum { STEPS = 20000, MAX_VALUES = 300 };
+    int expected[MAX_VALUES];
+    int n = 0;
+    unsigned int seed = 7;
+    XorList list;
+    initList(&list);
+    for (int step = 0; step < STEPS; step++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int r = seed >> 8;
+        if (r % 50 == 0) {
+            reverseList(&list);
+            for (int i = 0, j = n - 1; i < j; i++, j--) {
+                int temp = expected[i];
+                expected[i] = expected[j];
+                expected[j] = temp;
+            }
+        } else if (n < MAX_VALUES && (n == 0 || r % 2 == 0)) {
+            int index = (int)((r >> 8) % (unsigned int)(n + 1));
+            insertAfterIndex(&list, step, index);
+            memmove(expected + index + 1, expected + index, (n - index) * sizeof(int));
+            expected[index] = step;
+            n++;
+        } else {
+            int index = (int)((r >> 8) % (unsigned int)n);
+            deleteAtIndex(&list, index);
+            memmove(expected + index, expected + index + 1, (n - index - 1) * sizeof(int));
+            n--;
+        }
+        if (!checkList(&list, expected, n)) {
+            deleteList(&list);
+            return 0;
+        }
+    }
+    deleteList(&list);
+    return 1;
+}
+
+// Main function to demonstrate the XOR-linked list.
+int main() {
+    XorList list;
+    initList(&list);
+
+    // Same sequence of operations as the demo in 03.
+    printf("Initial list:\n");
+    insertAtEnd(&list, 10);
+    insertAtEnd(&list, 20);
+    insertAtEnd(&list, 30);
+    printList(&list);
+
+    printf("\nInsert 5 at the beginning:\n");
+    insertAtBeginning(&list, 5);
+    printList(&list);
+
+    printf("\nInsert 40 at the end:\n");
+    insertAtEnd(&list, 40);
+    printList(&list);
+
+    printf("\nInsert 25 after index 1:\n");
+    insertAfterIndex(&list, 25, 2);
+    printList(&list);
+
+    printf("\nDelete from the beginning:\n");
+    deleteFromBeginning(&list);
+    printList(&list);
+
+    printf("\nDelete node at index 2:\n");
+    deleteAtIndex(&list, 2);
+    printList(&list);
+
+    printf("\nDelete from the end:\n");
+    deleteFromEnd(&list);
+    printList(&list);
+
+    printf("\nReverse the list (O(1)):\n");
+    reverseList(&list);
+    printList(&list);
+
+    printf("\nBackward traversal:\n");
+    printListBackward(&list);
+    deleteList(&list);
+
+    printf("\nRandom indexed inserts, deletes and reversals match an array in both directions: %s\n",
+           checkRandomOperations() ? "ok" : "FAILED");
+
+    printf("\n");
+    reportMemory(1000000);
+    return 0;
+}
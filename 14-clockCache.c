@@ -0,0 +1,492 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+/*
+ * 14-clockCache.c: A CLOCK (second-chance) page cache.
+ * Explanation: Cached entries sit in a ring of ClockNodes, shaped like the circular linked list
+ * in 04 but with its own node type, all allocated once up front. Every entry has a reference
+ * bit that is set when it is used. To make room, a "hand" sweeps around the ring: referenced
+ * entries get their bit cleared (a second chance), and the first unreferenced entry is evicted
+ * and reused for the new key.
+ * A hash table maps keys to ring nodes so lookups never scan the ring.
+ * The program replays key traces through the CLOCK cache and a plain LRU cache and compares
+ * hit rate and speed.
+ * Usage: ./clockCache [capacity [traceFile]]   (traceFile: one integer key per line)
+ */
+
+/*
+ * KeyMap: Open-addressing hash table from an int key to a cache node, shared by both caches.
+ */
+#define SLOT_EMPTY 0      // Slot was never used.
+#define SLOT_USED 1       // Slot holds an entry.
+#define SLOT_DELETED 2    // Slot held an entry that was removed (tombstone).
+
+typedef struct {
+    int key;              // Cached key.
+    int state;            // SLOT_EMPTY, SLOT_USED or SLOT_DELETED.
+    void* node;           // Cache node holding the key.
+} MapSlot;
+
+typedef struct {
+    MapSlot* slots;       // Hash table, capacity is a power of two.
+    int capacity;         // Number of slots.
+    int shift;            // 32 - log2(capacity), for hashKey.
+    int filled;           // Slots in state SLOT_USED or SLOT_DELETED.
+} KeyMap;
+
+/*
+ * hashKey: Spreads an int key over a table of 2^(32 - shift) slots (Fibonacci hashing).
+ * Explanation: The top bits of the product are used; the low bits depend only on the low bits
+ * of the key, so keys with a power-of-two stride would all share one slot.
+ */
+unsigned int hashKey(int key, int shift) {
+    return ((unsigned int)key * 2654435769u) >> shift;
+}
+
+/*
+ * mapInit: Sizes the table for up to maxEntries live keys at most 50% load.
+ */
+void mapInit(KeyMap* map, int maxEntries) {
+    map->capacity = 16;
+    map->shift = 28;
+    while (map->capacity < maxEntries * 2) {
+        map->capacity *= 2;
+        map->shift--;
+    }
+    map->slots = (MapSlot*)calloc(map->capacity, sizeof(MapSlot));
+    if (map->slots == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    map->filled = 0;
+}
+
+/*
+ * mapFind: Returns the node cached under key, or NULL.
+ */
+void* mapFind(KeyMap* map, int key) {
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    for (unsigned int i = hashKey(key, map->shift); map->slots[i].state != SLOT_EMPTY; i = (i + 1) & mask) {
+        if (map->slots[i].state == SLOT_USED && map->slots[i].key == key)
+            return map->slots[i].node;
+    }
+    return NULL;
+}
+
+/*
+ * mapRemove: Removes key from the table, leaving a tombstone.
+ */
+void mapRemove(KeyMap* map, int key) {
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    for (unsigned int i = hashKey(key, map->shift); map->slots[i].state != SLOT_EMPTY; i = (i + 1) & mask) {
+        if (map->slots[i].state == SLOT_USED && map->slots[i].key == key) {
+            map->slots[i].state = SLOT_DELETED;
+            return;
+        }
+    }
+}
+
+/*
+ * mapPut: Adds key (which must not be present yet).
+ * Explanation: Evictions leave tombstones behind; once used plus deleted slots pass 75%
+ * the table is rebuilt in place to clear them.
+ */
+void mapPut(KeyMap* map, int key, void* node) {
+    if ((map->filled + 1) * 4 > map->capacity * 3) {
+        MapSlot* old = map->slots;
+        map->slots = (MapSlot*)calloc(map->capacity, sizeof(MapSlot));
+        if (map->slots == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        map->filled = 0;
+        for (int i = 0; i < map->capacity; i++) {
+            if (old[i].state == SLOT_USED) mapPut(map, old[i].key, old[i].node);
+        }
+        free(old);
+    }
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    unsigned int i = hashKey(key, map->shift);
+    while (map->slots[i].state == SLOT_USED) i = (i + 1) & mask;
+    if (map->slots[i].state == SLOT_EMPTY) map->filled++;
+    map->slots[i].key = key;
+    map->slots[i].state = SLOT_USED;
+    map->slots[i].node = node;
+}
+
+// Hit/miss/eviction counters kept by both caches.
+typedef struct {
+    long long hits;
+    long long misses;
+    long long evictions;
+} CacheStats;
+
+/*
+ * ClockCache: Ring of entries with reference bits and a sweeping hand.
+ */
+typedef struct ClockNode {
+    int key;                 // Key of the cached page.
+    int value;               // Cached value (stands in for the page contents).
+    int referenced;          // Set on every use, cleared when the hand passes.
+    struct ClockNode* next;  // Next entry in the ring.
+} ClockNode;
+
+typedef struct {
+    ClockNode* hand;         // Next eviction candidate; new entries are linked just behind it.
+    ClockNode* behind;       // Node whose next pointer is hand (the tail of the ring).
+    ClockNode* nodes;        // All ring nodes, allocated once for the whole capacity.
+    int capacity;            // Maximum number of entries.
+    int size;                // Current number of entries.
+    KeyMap map;              // Key -> ring node.
+    CacheStats stats;
+} ClockCache;
+
+/*
+ * clockInit: Creates an empty cache for up to capacity entries.
+ */
+void clockInit(ClockCache* cache, int capacity) {
+    cache->nodes = (ClockNode*)malloc(capacity * sizeof(ClockNode));
+    if (cache->nodes == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    cache->hand = cache->behind = NULL;
+    cache->capacity = capacity;
+    cache->size = 0;
+    mapInit(&cache->map, capacity);
+    cache->stats.hits = cache->stats.misses = cache->stats.evictions = 0;
+}
+
+/*
+ * clockFree: Releases the cache.
+ */
+void clockFree(ClockCache* cache) {
+    free(cache->nodes);
+    free(cache->map.slots);
+}
+
+/*
+ * clockGet: Looks up key; on a hit sets its reference bit and stores the value in *value.
+ * Returns 1 on a hit and 0 on a miss.
+ */
+int clockGet(ClockCache* cache, int key, int* value) {
+    ClockNode* node = (ClockNode*)mapFind(&cache->map, key);
+    if (node == NULL) {
+        cache->stats.misses++;
+        return 0;
+    }
+    node->referenced = 1;
+    *value = node->value;
+    cache->stats.hits++;
+    return 1;
+}
+
+/*
+ * clockPut: Inserts or updates key.
+ * Explanation: While the cache is not full, a new node is linked into the ring just behind the
+ * hand, so it is the last one the hand reaches. Once full, the hand sweeps forward clearing
+ * reference bits until it finds an unreferenced entry, which is reused in place for the new key.
+ */
+void clockPut(ClockCache* cache, int key, int value) {
+    ClockNode* node = (ClockNode*)mapFind(&cache->map, key);
+    if (node != NULL) {
+        node->value = value;
+        node->referenced = 1;
+        return;
+    }
+    if (cache->size < cache->capacity) {
+        node = &cache->nodes[cache->size++];
+        if (cache->hand == NULL) {
+            node->next = node;             // First entry: a ring of one.
+            cache->hand = cache->behind = node;
+        } else {
+            node->next = cache->hand;      // Link between behind and hand.
+            cache->behind->next = node;
+            cache->behind = node;
+        }
+    } else {
+        while (cache->hand->referenced) {
+            cache->hand->referenced = 0;   // Second chance.
+            cache->behind = cache->hand;
+            cache->hand = cache->hand->next;
+        }
+        node = cache->hand;                // Victim.
+        mapRemove(&cache->map, node->key);
+        cache->stats.evictions++;
+        cache->behind = node;              // The reused entry is now the newest one.
+        cache->hand = node->next;
+    }
+    node->key = key;
+    node->value = value;
+    node->referenced = 0;
+    mapPut(&cache->map, key, node);
+}
+
+/*
+ * LruCache: Plain least-recently-used cache (doubly linked list + hash) for comparison.
+ */
+typedef struct LruNode {
+    int key;
+    int value;
+    struct LruNode* prev;   // Towards the most recently used entry.
+    struct LruNode* next;   // Towards the least recently used entry.
+} LruNode;
+
+typedef struct {
+    LruNode* head;          // Most recently used.
+    LruNode* tail;          // Least recently used (next to evict).
+    LruNode* nodes;         // All nodes, allocated once for the whole capacity.
+    int capacity;
+    int size;
+    KeyMap map;
+    CacheStats stats;
+} LruCache;
+
+void lruInit(LruCache* cache, int capacity) {
+    cache->nodes = (LruNode*)malloc(capacity * sizeof(LruNode));
+    if (cache->nodes == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    cache->head = cache->tail = NULL;
+    cache->capacity = capacity;
+    cache->size = 0;
+    mapInit(&cache->map, capacity);
+    cache->stats.hits = cache->stats.misses = cache->stats.evictions = 0;
+}
+
+void lruFree(LruCache* cache) {
+    free(cache->nodes);
+    free(cache->map.slots);
+}
+
+// Unlinks a node from the recency list.
+void lruUnlink(LruCache* cache, LruNode* node) {
+    if (node->prev) node->prev->next = node->next; else cache->head = node->next;
+    if (node->next) node->next->prev = node->prev; else cache->tail = node->prev;
+}
+
+// Links a node in front of the recency list.
+void lruPushFront(LruCache* cache, LruNode* node) {
+    node->prev = NULL;
+    node->next = cache->head;
+    if (cache->head) cache->head->prev = node; else cache->tail = node;
+    cache->head = node;
+}
+
+/*
+ * lruGet: Like clockGet, but every hit also moves the entry to the front of the list.
+ */
+int lruGet(LruCache* cache, int key, int* value) {
+    LruNode* node = (LruNode*)mapFind(&cache->map, key);
+    if (node == NULL) {
+        cache->stats.misses++;
+        return 0;
+    }
+    if (node != cache->head) {
+        lruUnlink(cache, node);
+        lruPushFront(cache, node);
+    }
+    *value = node->value;
+    cache->stats.hits++;
+    return 1;
+}
+
+/*
+ * lruPut: Inserts or updates key, evicting the least recently used entry when full.
+ */
+void lruPut(LruCache* cache, int key, int value) {
+    LruNode* node = (LruNode*)mapFind(&cache->map, key);
+    if (node != NULL) {
+        node->value = value;
+        lruUnlink(cache, node);
+        lruPushFront(cache, node);
+        return;
+    }
+    if (cache->size < cache->capacity) {
+        node = &cache->nodes[cache->size++];
+    } else {
+        node = cache->tail;
+        lruUnlink(cache, node);
+        mapRemove(&cache->map, node->key);
+        cache->stats.evictions++;
+    }
+    node->key = key;
+    node->value = value;
+    lruPushFront(cache, node);
+    mapPut(&cache->map, key, node);
+}
+
+/*
+ * loadFromBackingStore: Stands in for the slow store behind the cache.
+ */
+int loadFromBackingStore(int key) {
+    return key * 2 + 1;
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * makeZipfTrace: Fills trace with n keys from [0, keys) drawn from a Zipf(s) distribution,
+ * the usual model for page popularity.
+ */
+void makeZipfTrace(int* trace, int n, int keys, double s, unsigned int seed) {
+    double* cdf = (double*)malloc(keys * sizeof(double));
+    double total = 0;
+    for (int k = 0; k < keys; k++) {
+        total += 1.0 / pow(k + 1, s);
+        cdf[k] = total;
+    }
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        double u = (seed >> 8) / 16777216.0 * total;
+        int lo = 0, hi = keys - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        trace[i] = lo;
+    }
+    free(cdf);
+}
+
+/*
+ * makeScanTrace: Zipf trace where every tenth request is part of a long sequential scan,
+ * the pattern that flushes an LRU cache.
+ */
+void makeScanTrace(int* trace, int n, int keys, unsigned int seed) {
+    makeZipfTrace(trace, n, keys, 0.9, seed);
+    for (int i = 0; i < n; i += 10) {
+        trace[i] = -1 - (i / 10); // Keys that are never reused.
+    }
+}
+
+/*
+ * replay: Runs a trace through both caches (get, and load + put on a miss) and prints the results.
+ */
+void replay(const char* name, int* trace, int n, int capacity) {
+    ClockCache clockCache;
+    LruCache lruCache;
+    int value;
+    long long checksum = 0;
+
+    clockInit(&clockCache, capacity);
+    double start = nowSeconds();
+    for (int i = 0; i < n; i++) {
+        if (!clockGet(&clockCache, trace[i], &value)) {
+            value = loadFromBackingStore(trace[i]);
+            clockPut(&clockCache, trace[i], value);
+        }
+        checksum += value;
+    }
+    double clockTime = nowSeconds() - start;
+
+    lruInit(&lruCache, capacity);
+    start = nowSeconds();
+    for (int i = 0; i < n; i++) {
+        if (!lruGet(&lruCache, trace[i], &value)) {
+            value = loadFromBackingStore(trace[i]);
+            lruPut(&lruCache, trace[i], value);
+        }
+        checksum -= value;
+    }
+    double lruTime = nowSeconds() - start;
+
+    printf("%-12s CLOCK: hit rate %6.2f%%  %7.2f Mops/s  evictions %lld\n", name,
+           100.0 * clockCache.stats.hits / n, n / clockTime / 1e6, clockCache.stats.evictions);
+    printf("%-12s LRU:   hit rate %6.2f%%  %7.2f Mops/s  evictions %lld%s\n", "",
+           100.0 * lruCache.stats.hits / n, n / lruTime / 1e6, lruCache.stats.evictions,
+           checksum == 0 ? "" : "  (VALUE MISMATCH)");
+    clockFree(&clockCache);
+    lruFree(&lruCache);
+}
+
+/*
+ * readTrace: Reads one integer key per line from a file. Returns the number of keys read.
+ */
+int readTrace(const char* path, int** trace) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Cannot open %s\n", path);
+        exit(1);
+    }
+    int capacity = 1 << 16, n = 0, key;
+    *trace = (int*)malloc(capacity * sizeof(int));
+    if (*trace == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    while (fscanf(file, "%d", &key) == 1) {
+        if (n == capacity) {
+            capacity *= 2;
+            int* grown = (int*)realloc(*trace, capacity * sizeof(int));
+            if (grown == NULL) {
+                printf("Memory allocation failed.\n");
+                exit(1);
+            }
+            *trace = grown;
+        }
+        (*trace)[n++] = key;
+    }
+    fclose(file);
+    return n;
+}
+
+// Main function to demonstrate the CLOCK cache and compare it with LRU.
+int main(int argc, char* argv[]) {
+    // Small walk-through of the second-chance policy.
+    ClockCache demo;
+    int value;
+    clockInit(&demo, 3);
+    clockPut(&demo, 1, 10);
+    clockPut(&demo, 2, 20);
+    clockPut(&demo, 3, 30);
+    clockGet(&demo, 1, &value);          // Key 1 gets its reference bit set.
+    clockPut(&demo, 4, 40);              // Hand skips 1 (second chance) and evicts 2.
+    printf("After using 1 and inserting 4: 1 %s, 2 %s\n",
+           clockGet(&demo, 1, &value) ? "cached" : "evicted",
+           clockGet(&demo, 2, &value) ? "cached" : "evicted");
+    printf("Hits %lld, misses %lld, evictions %lld\n\n",
+           demo.stats.hits, demo.stats.misses, demo.stats.evictions);
+    clockFree(&demo);
+
+    int capacity = argc > 1 ? atoi(argv[1]) : 10000;
+    if (capacity <= 0) {
+        printf("Usage: %s [capacity [traceFile]]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) {
+        int* trace;
+        int n = readTrace(argv[2], &trace);
+        if (n == 0) {
+            printf("%s holds no keys.\nUsage: %s [capacity [traceFile]]\n", argv[2], argv[0]);
+            free(trace);
+            return 1;
+        }
+        replay("trace file", trace, n, capacity);
+        free(trace);
+        return 0;
+    }
+
+    int n = 2000000, keys = 200000;
+    int* trace = (int*)malloc(n * sizeof(int));
+    if (trace == NULL) {
+        printf("Memory allocation failed.\n");
+        return 1;
+    }
+    printf("Cache capacity %d, %d requests over %d keys:\n", capacity, n, keys);
+    makeZipfTrace(trace, n, keys, 0.99, 1);
+    replay("zipf 0.99", trace, n, capacity);
+    makeZipfTrace(trace, n, keys, 0.7, 2);
+    replay("zipf 0.7", trace, n, capacity);
+    makeScanTrace(trace, n, keys, 3);
+    replay("zipf + scan", trace, n, capacity);
+    free(trace);
+    return 0;
+}
@@ -0,0 +1,568 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+/*
+ * 15-lockFreeList.c: A lock-free sorted singly linked list (Harris's algorithm) for sharing a
+ * list between threads without a global mutex.
+ * Explanation: insert, remove and contains never take a lock; every change is a single
+ * compare-and-swap (CAS) on a next pointer. A node is removed in two steps:
+ *   1. Logical deletion: the lowest bit of the node's own next pointer is set ("marked"), which
+ *      stops anyone from linking a new node after it.
+ *   2. Physical deletion: a CAS on the predecessor unlinks the marked node. Any thread that
+ *      walks past a marked node helps to unlink it.
+ * An unlinked node may still be read by threads that were already looking at it, so it is not
+ * freed right away. Epoch-based reclamation makes that safe: every operation announces the
+ * global epoch it runs in, and an unlinked node is freed only after the epoch has advanced
+ * twice, when no thread can still be inside an operation that saw it.
+ * The program runs a multi-threaded stress test and a scaling benchmark for 1..N threads.
+ * Usage: ./lockFreeList [maxThreads]
+ */
+
+#define MAX_THREADS 64         // Upper bound on threads using one list.
+#define CACHE_LINE 64          // Bytes per cache line.
+#define RETIRE_THRESHOLD 64    // Retired nodes a thread collects before trying to advance the epoch.
+
+// List node; the lowest bit of next is the deletion mark.
+typedef struct Node {
+    int key;                        // Keys are kept in ascending order.
+    _Atomic(uintptr_t) next;        // Pointer to the next node | deletion mark.
+} Node;
+
+// Helpers for the marked pointer stored in next.
+static inline Node* getPointer(uintptr_t link) { return (Node*)(link & ~(uintptr_t)1); }
+static inline int isMarked(uintptr_t link) { return (int)(link & 1); }
+static inline uintptr_t withMark(Node* node) { return (uintptr_t)node | 1; }
+
+// Nodes retired by one thread during one epoch.
+typedef struct {
+    Node** nodes;
+    int count;
+    int capacity;
+    unsigned int epoch;             // Epoch in which these nodes were retired.
+} RetiredBin;
+
+// Epoch state of one thread, aligned to a cache line so threads do not share lines.
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_uint state; // (epoch << 1) | 1 while inside an operation, 0 outside.
+    RetiredBin bins[3];             // Retired nodes of the last three epochs.
+    int sinceAdvance;               // Nodes retired since the last attempt to advance the epoch.
+} ThreadEpoch;
+
+// Lock-free list handle. Allocate it with aligned_alloc(CACHE_LINE, ...) to keep the alignment.
+typedef struct {
+    Node head;                      // Sentinel before the smallest key.
+    atomic_uint epoch;              // Global epoch.
+    ThreadEpoch threads[MAX_THREADS];
+    atomic_int threadCount;         // Number of registered threads.
+} LockFreeList;
+
+/*
+ * initList: Sets up an empty list.
+ */
+void initList(LockFreeList* list) {
+    list->head.key = 0;
+    atomic_init(&list->head.next, (uintptr_t)NULL);
+    atomic_init(&list->epoch, 0);
+    for (int t = 0; t < MAX_THREADS; t++) {
+        atomic_init(&list->threads[t].state, 0);
+        for (int b = 0; b < 3; b++) {
+            list->threads[t].bins[b].nodes = NULL;
+            list->threads[t].bins[b].count = list->threads[t].bins[b].capacity = 0;
+            list->threads[t].bins[b].epoch = 0;
+        }
+        list->threads[t].sinceAdvance = 0;
+    }
+    atomic_init(&list->threadCount, 0);
+}
+
+/*
+ * registerThread: Gives the calling thread an id for its epoch state.
+ */
+int registerThread(LockFreeList* list) {
+    int id = atomic_fetch_add(&list->threadCount, 1);
+    if (id >= MAX_THREADS) {
+        printf("Too many threads.\n");
+        exit(1);
+    }
+    return id;
+}
+
+/*
+ * freeBin: Frees the nodes of a bin once its epoch is at least two epochs old.
+ */
+static void freeBin(RetiredBin* bin, unsigned int currentEpoch) {
+    if (bin->count > 0 && currentEpoch - bin->epoch >= 2) {
+        for (int i = 0; i < bin->count; i++) free(bin->nodes[i]);
+        bin->count = 0;
+    }
+}
+
+/*
+ * enterEpoch: Marks the calling thread as active in the current global epoch.
+ * Explanation: Nodes that are unlinked while a thread is active are not freed until every thread
+ * has moved on to a later epoch, so the thread may follow any pointer it reads during the operation.
+ * The sequentially consistent store orders the announcement before the thread's reads of the list.
+ */
+static void enterEpoch(LockFreeList* list, int tid) {
+    unsigned int epoch = atomic_load(&list->epoch);
+    atomic_store(&list->threads[tid].state, (epoch << 1) | 1);
+}
+
+/*
+ * exitEpoch: Marks the calling thread as outside any operation.
+ */
+static void exitEpoch(LockFreeList* list, int tid) {
+    atomic_store_explicit(&list->threads[tid].state, 0, memory_order_release);
+}
+
+/*
+ * tryAdvanceEpoch: Moves the global epoch forward if every active thread has seen it.
+ */
+static void tryAdvanceEpoch(LockFreeList* list) {
+    unsigned int epoch = atomic_load(&list->epoch);
+    int threads = atomic_load(&list->threadCount);
+    for (int t = 0; t < threads; t++) {
+        unsigned int state = atomic_load(&list->threads[t].state);
+        if ((state & 1) && (state >> 1) != epoch) return; // A thread still runs in an older epoch.
+    }
+    atomic_compare_exchange_strong(&list->epoch, &epoch, epoch + 1);
+}
+
+/*
+ * retireNode: Hands an unlinked node over for delayed freeing.
+ * Explanation: The node goes into the bin of the current epoch. A thread that was active when
+ * the node was unlinked is at most one epoch behind, so once the global epoch is two ahead of
+ * the bin no thread can still hold a pointer to the node.
+ */
+static void retireNode(LockFreeList* list, int tid, Node* node) {
+    ThreadEpoch* self = &list->threads[tid];
+    unsigned int epoch = atomic_load(&list->epoch);
+    RetiredBin* bin = &self->bins[epoch % 3];
+    if (bin->epoch != epoch) {
+        freeBin(bin, epoch);   // Reusing the slot of epoch - 3.
+        bin->epoch = epoch;
+    }
+    if (bin->count == bin->capacity) {
+        bin->capacity = bin->capacity ? bin->capacity * 2 : RETIRE_THRESHOLD * 2;
+        bin->nodes = (Node**)realloc(bin->nodes, bin->capacity * sizeof(Node*));
+        if (bin->nodes == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    bin->nodes[bin->count++] = node;
+    if (++self->sinceAdvance >= RETIRE_THRESHOLD) {
+        self->sinceAdvance = 0;
+        tryAdvanceEpoch(list);
+        epoch = atomic_load(&list->epoch);
+        for (int b = 0; b < 3; b++) freeBin(&self->bins[b], epoch);
+    }
+}
+
+/*
+ * search: Finds adjacent nodes left and right with left->key < key <= right->key.
+ * Explanation: This is Harris's search. It walks the list remembering the last unmarked node
+ * (left) and stops at the first unmarked node with a key >= key (right, NULL at the end).
+ * If marked nodes lie between them, one CAS on left->next unlinks the whole run of them at once
+ * and the winner of that CAS retires them. If left or right changed meanwhile, the search restarts.
+ */
+static Node* search(LockFreeList* list, int tid, int key, Node** leftOut) {
+    for (;;) {
+        Node* left = &list->head;
+        uintptr_t leftNext = atomic_load(&list->head.next);
+        Node* t = &list->head;
+        uintptr_t tNext = leftNext;
+
+        // 1. Find left and right.
+        do {
+            if (!isMarked(tNext)) {
+                left = t;
+                leftNext = tNext;
+            }
+            t = getPointer(tNext);
+            if (t == NULL) break;
+            tNext = atomic_load(&t->next);
+        } while (isMarked(tNext) || t->key < key);
+        Node* right = t;
+
+        // 2. Already adjacent.
+        if (leftNext == (uintptr_t)right) {
+            if (right != NULL && isMarked(atomic_load(&right->next))) continue;
+            *leftOut = left;
+            return right;
+        }
+
+        // 3. Unlink the marked nodes between left and right.
+        if (atomic_compare_exchange_strong(&left->next, &leftNext, (uintptr_t)right)) {
+            Node* node = getPointer(leftNext);
+            while (node != right) {
+                Node* nextNode = getPointer(atomic_load(&node->next));
+                retireNode(list, tid, node);
+                node = nextNode;
+            }
+            if (right != NULL && isMarked(atomic_load(&right->next))) continue;
+            *leftOut = left;
+            return right;
+        }
+    }
+}
+
+/*
+ * insert: Inserts key if it is not in the list. Returns 1 if inserted, 0 if already present.
+ * Explanation: The new node is linked with one CAS on left->next; the CAS fails if left changed
+ * or was marked meanwhile, and the search is repeated.
+ */
+int insert(LockFreeList* list, int tid, int key) {
+    Node* newNode = (Node*)malloc(sizeof(Node));
+    if (newNode == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    newNode->key = key;
+    enterEpoch(list, tid);
+    for (;;) {
+        Node* left;
+        Node* right = search(list, tid, key, &left);
+        if (right != NULL && right->key == key) {
+            exitEpoch(list, tid);
+            free(newNode);
+            return 0;
+        }
+        atomic_store_explicit(&newNode->next, (uintptr_t)right, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)right;
+        if (atomic_compare_exchange_strong(&left->next, &expected, (uintptr_t)newNode)) {
+            exitEpoch(list, tid);
+            return 1;
+        }
+    }
+}
+
+/*
+ * removeKey: Removes key from the list. Returns 1 if removed, 0 if it was not present.
+ * Explanation: The node is first marked (logical deletion; the CAS decides the winner among
+ * concurrent removers), then unlinked. If unlinking fails, another search finishes the job.
+ */
+int removeKey(LockFreeList* list, int tid, int key) {
+    enterEpoch(list, tid);
+    Node* left;
+    Node* right;
+    uintptr_t rightNext;
+    for (;;) {
+        right = search(list, tid, key, &left);
+        if (right == NULL || right->key != key) {
+            exitEpoch(list, tid);
+            return 0;
+        }
+        rightNext = atomic_load(&right->next);
+        if (!isMarked(rightNext) &&
+            atomic_compare_exchange_strong(&right->next, &rightNext, withMark(getPointer(rightNext)))) {
+            break;
+        }
+    }
+    uintptr_t expected = (uintptr_t)right;
+    if (atomic_compare_exchange_strong(&left->next, &expected, rightNext)) {
+        retireNode(list, tid, right);
+    } else {
+        search(list, tid, key, &left);
+    }
+    exitEpoch(list, tid);
+    return 1;
+}
+
+/*
+ * contains: Returns 1 if key is in the list and not logically deleted.
+ * Explanation: A read-only walk that simply steps over marked nodes; it never writes to the
+ * list and never restarts. The epoch keeps every node it can reach alive during the walk.
+ */
+int contains(LockFreeList* list, int tid, int key) {
+    enterEpoch(list, tid);
+    Node* curr = getPointer(atomic_load(&list->head.next));
+    while (curr != NULL && curr->key < key) {
+        curr = getPointer(atomic_load(&curr->next));
+    }
+    int found = curr != NULL && curr->key == key && !isMarked(atomic_load(&curr->next));
+    exitEpoch(list, tid);
+    return found;
+}
+
+/*
+ * destroyList: Frees every node and every retired node. Only call when no thread uses the list.
+ */
+void destroyList(LockFreeList* list) {
+    Node* node = getPointer(atomic_load(&list->head.next));
+    while (node != NULL) {
+        Node* next = getPointer(atomic_load(&node->next));
+        free(node);
+        node = next;
+    }
+    atomic_store(&list->head.next, (uintptr_t)NULL);
+    for (int t = 0; t < MAX_THREADS; t++) {
+        for (int b = 0; b < 3; b++) {
+            RetiredBin* bin = &list->threads[t].bins[b];
+            for (int i = 0; i < bin->count; i++) free(bin->nodes[i]);
+            free(bin->nodes);
+            bin->nodes = NULL;
+            bin->count = bin->capacity = 0;
+        }
+    }
+}
+
+/*
+ * printList: Prints the keys that are not logically deleted (single-threaded use only).
+ */
+void printList(LockFreeList* list) {
+    for (Node* node = getPointer(atomic_load(&list->head.next)); node != NULL;
+         node = getPointer(atomic_load(&node->next))) {
+        if (!isMarked(atomic_load(&node->next))) printf("%d -> ", node->key);
+    }
+    printf("NULL\n");
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Sorted singly linked list in the style of 02, shared through one global mutex.
+ * This is the baseline the lock-free list replaces.
+ */
+struct PlainNode {
+    int key;
+    struct PlainNode* next;
+};
+
+typedef struct {
+    struct PlainNode* head;
+    pthread_mutex_t mutex;    // Serializes every operation.
+} LockedList;
+
+// Returns the link that points to the first node with a key >= key.
+struct PlainNode** plainFind(LockedList* list, int key) {
+    struct PlainNode** link = &list->head;
+    while (*link != NULL && (*link)->key < key) link = &(*link)->next;
+    return link;
+}
+
+int lockedInsert(LockedList* list, int key) {
+    pthread_mutex_lock(&list->mutex);
+    struct PlainNode** link = plainFind(list, key);
+    int inserted = *link == NULL || (*link)->key != key;
+    if (inserted) {
+        struct PlainNode* node = (struct PlainNode*)malloc(sizeof(struct PlainNode));
+        node->key = key;
+        node->next = *link;
+        *link = node;
+    }
+    pthread_mutex_unlock(&list->mutex);
+    return inserted;
+}
+
+int lockedRemove(LockedList* list, int key) {
+    pthread_mutex_lock(&list->mutex);
+    struct PlainNode** link = plainFind(list, key);
+    int removed = *link != NULL && (*link)->key == key;
+    if (removed) {
+        struct PlainNode* node = *link;
+        *link = node->next;
+        free(node);
+    }
+    pthread_mutex_unlock(&list->mutex);
+    return removed;
+}
+
+int lockedContains(LockedList* list, int key) {
+    pthread_mutex_lock(&list->mutex);
+    struct PlainNode** link = plainFind(list, key);
+    int found = *link != NULL && (*link)->key == key;
+    pthread_mutex_unlock(&list->mutex);
+    return found;
+}
+
+// Arguments and results of one worker thread.
+typedef struct {
+    LockFreeList* list;
+    LockedList* locked;       // When set, the worker uses the mutex baseline instead of list.
+    int threadIndex;          // Position among the workers.
+    int threads;              // Number of workers.
+    int operations;           // Operations to perform.
+    int keyRange;             // Keys are drawn from [0, keyRange).
+    long long inserted;       // Successful inserts.
+    long long removed;        // Successful removals.
+} Worker;
+
+/*
+ * stressWorker: Random inserts, removals and lookups.
+ * Explanation: Even keys are shared by all threads, so they race on the same nodes. Each odd key
+ * is changed only by its owner thread, which tracks it in a private bitmap and checks every
+ * answer the shared list gives for it. Other threads only look odd keys up, while their
+ * neighbours are being inserted and removed.
+ */
+void* stressWorker(void* arg) {
+    Worker* w = (Worker*)arg;
+    int tid = registerThread(w->list);
+    unsigned char* mine = (unsigned char*)calloc(w->keyRange, 1);
+    unsigned int seed = 12345u + w->threadIndex * 7919u;
+    for (int i = 0; i < w->operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int key = (int)((seed >> 8) % (unsigned int)w->keyRange);
+        int op = (seed >> 4) % 3;
+        int shared = key % 2 == 0;
+        int owned = !shared && (key / 2) % w->threads == w->threadIndex;
+        if (!shared && !owned) op = 2;
+        if (op == 0) {
+            int r = insert(w->list, tid, key);
+            if (owned && r == mine[key]) { printf("Stress test failed: insert %d\n", key); exit(1); }
+            if (owned) mine[key] = 1;
+            w->inserted += r;
+        } else if (op == 1) {
+            int r = removeKey(w->list, tid, key);
+            if (owned && r != mine[key]) { printf("Stress test failed: remove %d\n", key); exit(1); }
+            if (owned) mine[key] = 0;
+            w->removed += r;
+        } else {
+            int r = contains(w->list, tid, key);
+            if (owned && r != mine[key]) { printf("Stress test failed: contains %d\n", key); exit(1); }
+        }
+    }
+    free(mine);
+    return NULL;
+}
+
+/*
+ * stressTest: Runs threads that insert, remove and look up overlapping keys, then checks that
+ * the final list is sorted, has no duplicates, and that its size matches the successful operations.
+ */
+void stressTest(int threads, int operations, int keyRange) {
+    LockFreeList* list = (LockFreeList*)aligned_alloc(CACHE_LINE, sizeof(LockFreeList));
+    initList(list);
+    pthread_t ids[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        Worker w = { list, NULL, t, threads, operations, keyRange, 0, 0 };
+        workers[t] = w;
+        pthread_create(&ids[t], NULL, stressWorker, &workers[t]);
+    }
+    long long expected = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        expected += workers[t].inserted - workers[t].removed;
+    }
+    long long count = 0;
+    int last = -1, sorted = 1;
+    for (Node* node = getPointer(atomic_load(&list->head.next)); node != NULL;
+         node = getPointer(atomic_load(&node->next))) {
+        if (isMarked(atomic_load(&node->next))) continue;
+        if (node->key <= last) sorted = 0;
+        last = node->key;
+        count++;
+    }
+    printf("Stress test, %d threads x %d ops over %d keys: %lld keys left, expected %lld, %s -> %s\n",
+           threads, operations, keyRange, count, expected, sorted ? "sorted" : "NOT SORTED",
+           sorted && count == expected ? "OK" : "FAILED");
+    destroyList(list);
+    free(list);
+    if (!sorted || count != expected) exit(1);
+}
+
+/*
+ * benchWorker: Mixed workload of 80% contains, 10% insert and 10% remove.
+ */
+void* benchWorker(void* arg) {
+    Worker* w = (Worker*)arg;
+    int tid = w->locked ? 0 : registerThread(w->list);
+    unsigned int seed = 99u + w->threadIndex * 31337u;
+    for (int i = 0; i < w->operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int key = (int)((seed >> 8) % (unsigned int)w->keyRange);
+        int op = (seed >> 4) % 10;
+        if (w->locked) {
+            if (op == 0) lockedInsert(w->locked, key);
+            else if (op == 1) lockedRemove(w->locked, key);
+            else lockedContains(w->locked, key);
+        } else {
+            if (op == 0) insert(w->list, tid, key);
+            else if (op == 1) removeKey(w->list, tid, key);
+            else contains(w->list, tid, key);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * benchmark: Measures total throughput for 1..maxThreads threads (doubling, ending at maxThreads),
+ * lock-free list versus the 02-style list behind one global mutex.
+ */
+void benchmark(int maxThreads, int operations, int keyRange) {
+    printf("\nScaling, %d ops per thread, 80%% contains / 10%% insert / 10%% remove over %d keys:\n",
+           operations, keyRange);
+    printf("threads   lock-free Mops/s   global mutex Mops/s\n");
+    for (int threads = 1; threads <= maxThreads;
+         threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        double rate[2];
+        for (int useMutex = 0; useMutex < 2; useMutex++) {
+            LockFreeList* list = (LockFreeList*)aligned_alloc(CACHE_LINE, sizeof(LockFreeList));
+            LockedList locked = { NULL, PTHREAD_MUTEX_INITIALIZER };
+            initList(list);
+            int tid = registerThread(list);
+            for (int k = 0; k < keyRange; k += 2) {
+                // Start half full.
+                if (useMutex) lockedInsert(&locked, k);
+                else insert(list, tid, k);
+            }
+            pthread_t ids[MAX_THREADS];
+            Worker workers[MAX_THREADS];
+            double start = nowSeconds();
+            for (int t = 0; t < threads; t++) {
+                Worker w = { list, useMutex ? &locked : NULL, t, threads, operations, keyRange, 0, 0 };
+                workers[t] = w;
+                pthread_create(&ids[t], NULL, benchWorker, &workers[t]);
+            }
+            for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+            rate[useMutex] = (double)threads * operations / (nowSeconds() - start) / 1e6;
+            destroyList(list);
+            free(list);
+            while (locked.head != NULL) {
+                struct PlainNode* next = locked.head->next;
+                free(locked.head);
+                locked.head = next;
+            }
+        }
+        printf("%7d   %16.2f   %19.2f\n", threads, rate[0], rate[1]);
+    }
+}
+
+// Main function to demonstrate the lock-free list, stress-test it and measure scaling.
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : 8;
+    if (maxThreads < 1 || maxThreads > MAX_THREADS - 1) {
+        printf("Usage: %s [maxThreads (1..%d)]\n", argv[0], MAX_THREADS - 1);
+        return 1;
+    }
+
+    // Single-threaded walk-through.
+    LockFreeList* list = (LockFreeList*)aligned_alloc(CACHE_LINE, sizeof(LockFreeList));
+    initList(list);
+    int tid = registerThread(list);
+    insert(list, tid, 30);
+    insert(list, tid, 10);
+    insert(list, tid, 20);
+    printf("Insert 30, 10, 20 (kept sorted):\n");
+    printList(list);
+    printf("Insert 20 again: %s\n", insert(list, tid, 20) ? "inserted" : "already present");
+    removeKey(list, tid, 10);
+    printf("Remove 10:\n");
+    printList(list);
+    printf("Contains 20: %d, contains 10: %d\n\n", contains(list, tid, 20), contains(list, tid, 10));
+    destroyList(list);
+    free(list);
+
+    stressTest(maxThreads, 200000, 1024);
+    benchmark(maxThreads, 200000, 1000);
+    return 0;
+}
@@ -0,0 +1,479 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "genericStack.h"
+
+/*
+ * 16-treiberStack.c: A lock-free stack (Treiber's algorithm) that threads can share, for
+ * example as a common free list, where the array stack of 05 would need a lock.
+ * Explanation: The stack is a singly linked list whose top is changed with one compare-and-swap
+ * (CAS) per push or pop. Nodes live in one array and are addressed by 32-bit indices, like the
+ * pool in 13, so the top of the stack fits into one 64-bit word together with a 32-bit tag that
+ * is incremented by every successful CAS. That tag prevents the ABA problem: if a node is popped
+ * and pushed again while another thread is about to pop it, the top word has a different tag and
+ * the stale CAS fails. Unused nodes are kept on a second Treiber stack, so nodes are never handed
+ * back to malloc while the stack is in use and a stale read of a node is always harmless.
+ * When a CAS fails because of contention, the thread tries the elimination array instead: a
+ * pusher leaves its value in a random slot for a short while, and a popper that finds it takes
+ * the value directly. Such a pair cancels out without touching the top of the stack.
+ * The program runs a multi-threaded stress test and a benchmark against the array stack of 05
+ * behind a mutex.
+ * Usage: ./treiberStack [maxThreads]
+ */
+
+#define NIL 0u                 // Node index 0 is reserved and means "no node".
+#define MAX_THREADS 64         // Upper bound on threads in the stress test and the benchmark.
+#define ELIMINATION_SLOTS 16   // Slots of the elimination array.
+#define ELIMINATION_SPINS 128  // Times a pusher checks its slot before it withdraws its offer.
+
+// Stack node, addressed by its index in the stack's node array.
+typedef struct {
+    int data;                       // Value stored in the node.
+    _Atomic(uint32_t) next;         // Index of the node below, NIL at the bottom. Atomic because a
+                                    // popper may read it while the node is already being reused.
+} TNode;
+
+// State of an elimination slot, kept in the upper half of the slot word.
+#define SLOT_EMPTY 0u               // Nobody uses the slot.
+#define SLOT_OFFERED 1u             // A pusher offers the value in the lower half.
+#define SLOT_TAKEN 2u               // A popper took the value; the pusher empties the slot.
+
+// One slot of the elimination array, on its own cache line.
+typedef struct {
+    _Atomic(uint64_t) word;         // (state << 32) | (uint32_t)value.
+    char padding[64 - sizeof(uint64_t)];
+} EliminationSlot;
+
+// Lock-free stack handle. Both top words are (tag << 32) | node index.
+typedef struct {
+    _Atomic(uint64_t) head;         // Top of the stack.
+    char headPadding[64 - sizeof(uint64_t)];
+    _Atomic(uint64_t) freeHead;     // Top of the stack of unused nodes.
+    char freePadding[64 - sizeof(uint64_t)];
+    TNode* nodes;                   // Node array; nodes[0] is unused so that index 0 can mean NIL.
+    uint32_t capacity;              // Number of usable nodes.
+    int useElimination;             // Fall back to the elimination array under contention.
+    atomic_llong eliminated;        // Push/pop pairs that met in the elimination array.
+    EliminationSlot slots[ELIMINATION_SLOTS];
+} TreiberStack;
+
+// Per-thread random state for picking elimination slots.
+static _Thread_local unsigned int slotSeed = 1;
+
+// Helpers for the tagged top words.
+static inline uint32_t topIndex(uint64_t top) { return (uint32_t)top; }
+static inline uint64_t nextTop(uint64_t oldTop, uint32_t index) {
+    return ((oldTop >> 32) + 1) << 32 | index;   // New index, tag incremented.
+}
+
+/*
+ * tryPushIndex: Makes one attempt to push node index onto the stack whose top word is top.
+ * Explanation: Returns 1 on success and 0 if another thread changed the top in the meantime.
+ * The release CAS publishes the node's data and next to the thread that pops it.
+ */
+static int tryPushIndex(_Atomic(uint64_t)* top, TNode* nodes, uint32_t index) {
+    uint64_t old = atomic_load_explicit(top, memory_order_relaxed);
+    atomic_store_explicit(&nodes[index].next, topIndex(old), memory_order_relaxed);
+    return atomic_compare_exchange_strong_explicit(top, &old, nextTop(old, index),
+                                                   memory_order_release, memory_order_relaxed);
+}
+
+/*
+ * tryPopIndex: Makes one attempt to pop a node from the stack whose top word is top.
+ * Explanation: Returns 1 when the attempt is finished, with *index set to the popped node or to
+ * NIL if the stack was empty, and 0 if another thread changed the top in the meantime. The next
+ * index read before the CAS may be stale if the node was popped and reused concurrently; the tag
+ * makes the CAS fail in exactly that case.
+ */
+static int tryPopIndex(_Atomic(uint64_t)* top, TNode* nodes, uint32_t* index) {
+    uint64_t old = atomic_load_explicit(top, memory_order_acquire);
+    uint32_t first = topIndex(old);
+    if (first == NIL) {
+        *index = NIL;
+        return 1;
+    }
+    uint32_t below = atomic_load_explicit(&nodes[first].next, memory_order_relaxed);
+    if (atomic_compare_exchange_strong_explicit(top, &old, nextTop(old, below),
+                                                memory_order_acquire, memory_order_relaxed)) {
+        *index = first;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * allocNode / freeNode: Take a node from and return a node to the stack of unused nodes.
+ * Explanation: allocNode returns NIL when every node is in use.
+ */
+static uint32_t allocNode(TreiberStack* s) {
+    uint32_t index;
+    while (!tryPopIndex(&s->freeHead, s->nodes, &index)) {
+    }
+    return index;
+}
+
+static void freeNode(TreiberStack* s, uint32_t index) {
+    while (!tryPushIndex(&s->freeHead, s->nodes, index)) {
+    }
+}
+
+/*
+ * initStack: Creates an empty stack that can hold up to capacity values.
+ * Explanation: All nodes are allocated up front and put on the stack of unused nodes.
+ */
+void initStack(TreiberStack* s, uint32_t capacity, int useElimination) {
+    s->nodes = (TNode*)malloc(((size_t)capacity + 1) * sizeof(TNode));
+    if (s->nodes == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    s->capacity = capacity;
+    s->useElimination = useElimination;
+    atomic_init(&s->head, NIL);
+    for (uint32_t i = capacity; i >= 1; i--) {
+        atomic_init(&s->nodes[i].next, i == capacity ? NIL : i + 1);
+    }
+    atomic_init(&s->freeHead, capacity > 0 ? 1u : NIL);
+    atomic_init(&s->eliminated, 0);
+    for (int i = 0; i < ELIMINATION_SLOTS; i++) {
+        atomic_init(&s->slots[i].word, (uint64_t)SLOT_EMPTY << 32);
+    }
+}
+
+/*
+ * destroyStack: Releases the node array. No thread may use the stack any more.
+ */
+void destroyStack(TreiberStack* s) {
+    free(s->nodes);
+    s->nodes = NULL;
+    s->capacity = 0;
+}
+
+/*
+ * pickSlot: Returns a random slot of the elimination array (xorshift per thread).
+ */
+static EliminationSlot* pickSlot(TreiberStack* s) {
+    unsigned int x = slotSeed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    slotSeed = x;
+    return &s->slots[x % ELIMINATION_SLOTS];
+}
+
+/*
+ * eliminatePush: Offers value to a concurrent pop through the elimination array.
+ * Explanation: The pusher claims an empty slot, waits a little for a popper to mark it taken and
+ * then withdraws. If the withdrawing CAS fails, a popper took the value just before. Returns 1
+ * when a popper took the value.
+ */
+static int eliminatePush(TreiberStack* s, int value) {
+    EliminationSlot* slot = pickSlot(s);
+    uint64_t expected = (uint64_t)SLOT_EMPTY << 32;
+    uint64_t offer = (uint64_t)SLOT_OFFERED << 32 | (uint32_t)value;
+    if (!atomic_compare_exchange_strong_explicit(&slot->word, &expected, offer,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return 0; // Slot is busy, go back to the stack.
+    }
+    for (int i = 0; i < ELIMINATION_SPINS; i++) {
+        if (atomic_load_explicit(&slot->word, memory_order_relaxed) >> 32 == SLOT_TAKEN) {
+            break;
+        }
+    }
+    expected = offer;
+    if (atomic_compare_exchange_strong_explicit(&slot->word, &expected, (uint64_t)SLOT_EMPTY << 32,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        return 0; // Nobody came; the offer is withdrawn.
+    }
+    atomic_store_explicit(&slot->word, (uint64_t)SLOT_EMPTY << 32, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->eliminated, 1, memory_order_relaxed);
+    return 1;
+}
+
+/*
+ * eliminatePop: Takes a value offered by a concurrent push, if a random slot holds one.
+ * Explanation: The value travels inside the slot word, so taking it is a single CAS.
+ */
+static int eliminatePop(TreiberStack* s, int* value) {
+    EliminationSlot* slot = pickSlot(s);
+    uint64_t word = atomic_load_explicit(&slot->word, memory_order_relaxed);
+    if (word >> 32 != SLOT_OFFERED) {
+        return 0;
+    }
+    if (atomic_compare_exchange_strong_explicit(&slot->word, &word, (uint64_t)SLOT_TAKEN << 32,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        *value = (int)(uint32_t)word;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * push: Pushes value onto the stack. Returns 1 on success and 0 if all nodes are in use.
+ * Explanation: Every failed CAS on the top is followed by one elimination attempt.
+ */
+int push(TreiberStack* s, int value) {
+    uint32_t index = allocNode(s);
+    if (index == NIL) {
+        return 0;
+    }
+    s->nodes[index].data = value;
+    while (!tryPushIndex(&s->head, s->nodes, index)) {
+        if (s->useElimination && eliminatePush(s, value)) {
+            freeNode(s, index); // A popper took the value; the node was never linked.
+            return 1;
+        }
+    }
+    return 1;
+}
+
+/*
+ * pop: Pops the top value into *value. Returns 1 on success and 0 if the stack is empty.
+ * Explanation: After a successful CAS the node belongs to this thread alone, so its data can be
+ * read before the node goes back to the stack of unused nodes.
+ */
+int pop(TreiberStack* s, int* value) {
+    uint32_t index;
+    while (!tryPopIndex(&s->head, s->nodes, &index)) {
+        if (s->useElimination && eliminatePop(s, value)) {
+            return 1;
+        }
+    }
+    if (index == NIL) {
+        return 0;
+    }
+    *value = s->nodes[index].data;
+    freeNode(s, index);
+    return 1;
+}
+
+/*
+ * printStack: Prints the stack from top to bottom. Only safe while no other thread uses it.
+ */
+void printStack(TreiberStack* s) {
+    printf("Stack elements (top to bottom): ");
+    for (uint32_t i = topIndex(atomic_load(&s->head)); i != NIL; i = atomic_load(&s->nodes[i].next)) {
+        printf("%d ", s->nodes[i].data);
+    }
+    printf("\n");
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * The growable array stack of 05 (from genericStack.h), shared through one mutex.
+ * This is the baseline the lock-free stack replaces.
+ */
+DEFINE_STACK(ArrayStack, int, Array, 16)
+
+typedef struct {
+    ArrayStack stack;
+    pthread_mutex_t mutex;    // Serializes every operation.
+} LockedStack;
+
+void initLockedStack(LockedStack* s) {
+    initArrayStack(&s->stack);
+    pthread_mutex_init(&s->mutex, NULL);
+}
+
+void lockedPush(LockedStack* s, int value) {
+    pthread_mutex_lock(&s->mutex);
+    pushArray(&s->stack, value);
+    pthread_mutex_unlock(&s->mutex);
+}
+
+int lockedPop(LockedStack* s, int* value) {
+    pthread_mutex_lock(&s->mutex);
+    int popped = !isEmptyArray(&s->stack);
+    if (popped) {
+        *value = popArray(&s->stack);
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return popped;
+}
+
+void destroyLockedStack(LockedStack* s) {
+    freeArrayStack(&s->stack);
+    pthread_mutex_destroy(&s->mutex);
+}
+
+// Arguments and results of one worker thread.
+typedef struct {
+    TreiberStack* stack;
+    LockedStack* locked;      // When set, the worker uses the mutex baseline instead of stack.
+    atomic_uchar* seen;       // Stress test: how often each value was popped.
+    int threadIndex;          // Position among the workers.
+    int operations;           // Operations to perform.
+    long long pushed;         // Successful pushes.
+    long long popped;         // Successful pops.
+} Worker;
+
+/*
+ * stressWorker: Random pushes and pops of values that are unique across all threads.
+ * Explanation: Thread t pushes t * operations + i in its i-th operation. Every popped value is
+ * counted in seen, so a value that comes out twice (a lost or duplicated node) is caught.
+ */
+void* stressWorker(void* arg) {
+    Worker* w = (Worker*)arg;
+    unsigned int seed = 12345u + w->threadIndex * 7919u;
+    slotSeed = seed | 1;
+    for (int i = 0; i < w->operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int value;
+        if ((seed >> 16) & 1) {
+            if (!push(w->stack, w->threadIndex * w->operations + i)) {
+                printf("Stress test failed: stack full\n");
+                exit(1);
+            }
+            w->pushed++;
+        } else if (pop(w->stack, &value)) {
+            if (atomic_fetch_add(&w->seen[value], 1) != 0) {
+                printf("Stress test failed: %d popped twice\n", value);
+                exit(1);
+            }
+            w->popped++;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * stressTest: Runs threads that push and pop concurrently, then drains the stack and checks that
+ * every pushed value came out exactly once and every node is back on the stack of unused nodes.
+ */
+void stressTest(int threads, int operations) {
+    TreiberStack* stack = (TreiberStack*)malloc(sizeof(TreiberStack));
+    initStack(stack, (uint32_t)threads * operations, 1);
+    atomic_uchar* seen = (atomic_uchar*)calloc((size_t)threads * operations, sizeof(atomic_uchar));
+    pthread_t ids[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        Worker w = { stack, NULL, seen, t, operations, 0, 0 };
+        workers[t] = w;
+        pthread_create(&ids[t], NULL, stressWorker, &workers[t]);
+    }
+    long long pushed = 0, popped = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        pushed += workers[t].pushed;
+        popped += workers[t].popped;
+    }
+    int value, ok = 1;
+    long long left = 0;
+    while (pop(stack, &value)) {
+        if (atomic_fetch_add(&seen[value], 1) != 0) ok = 0;
+        left++;
+    }
+    uint32_t freeNodes = 0;
+    for (uint32_t i = topIndex(atomic_load(&stack->freeHead)); i != NIL; i = atomic_load(&stack->nodes[i].next)) {
+        freeNodes++;
+    }
+    ok = ok && popped + left == pushed && freeNodes == stack->capacity;
+    printf("Stress test, %d threads x %d ops: %lld pushed, %lld popped, %lld left, %lld eliminated -> %s\n",
+           threads, operations, pushed, popped, left, (long long)atomic_load(&stack->eliminated),
+           ok ? "OK" : "FAILED");
+    destroyStack(stack);
+    free(stack);
+    free(seen);
+    if (!ok) exit(1);
+}
+
+/*
+ * benchWorker: 50% pushes and 50% pops on the shared stack.
+ */
+void* benchWorker(void* arg) {
+    Worker* w = (Worker*)arg;
+    unsigned int seed = 99u + w->threadIndex * 31337u;
+    slotSeed = seed | 1;
+    int value;
+    for (int i = 0; i < w->operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) & 1) {
+            if (w->locked) lockedPush(w->locked, i);
+            else push(w->stack, i);
+        } else {
+            if (w->locked) lockedPop(w->locked, &value);
+            else pop(w->stack, &value);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * benchmark: Measures total throughput for 1..maxThreads threads (doubling, ending at maxThreads):
+ * the lock-free stack with and without elimination versus the 05-style stack behind a mutex.
+ */
+void benchmark(int maxThreads, int operations) {
+    printf("\nContention benchmark, %d ops per thread, 50%% push / 50%% pop:\n", operations);
+    printf("threads   lock-free Mops/s   +elimination Mops/s   (eliminated)   mutex Mops/s\n");
+    for (int threads = 1; threads <= maxThreads;
+         threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        double rate[3];
+        long long eliminated = 0;
+        for (int variant = 0; variant < 3; variant++) {
+            TreiberStack* stack = (TreiberStack*)malloc(sizeof(TreiberStack));
+            LockedStack locked;
+            initStack(stack, (uint32_t)threads * operations + 1000, variant == 1);
+            initLockedStack(&locked);
+            for (int i = 0; i < 1000; i++) {
+                // Start with some values on the stack.
+                if (variant == 2) lockedPush(&locked, i);
+                else push(stack, i);
+            }
+            pthread_t ids[MAX_THREADS];
+            Worker workers[MAX_THREADS];
+            double start = nowSeconds();
+            for (int t = 0; t < threads; t++) {
+                Worker w = { stack, variant == 2 ? &locked : NULL, NULL, t, operations, 0, 0 };
+                workers[t] = w;
+                pthread_create(&ids[t], NULL, benchWorker, &workers[t]);
+            }
+            for (int t = 0; t < threads; t++) pthread_join(ids[t], NULL);
+            rate[variant] = (double)threads * operations / (nowSeconds() - start) / 1e6;
+            if (variant == 1) eliminated = atomic_load(&stack->eliminated);
+            destroyStack(stack);
+            free(stack);
+            destroyLockedStack(&locked);
+        }
+        printf("%7d   %16.2f   %19.2f   %12lld   %12.2f\n", threads, rate[0], rate[1], eliminated, rate[2]);
+    }
+}
+
+// Main function to demonstrate the lock-free stack, stress-test it and measure contention.
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : 8;
+    if (maxThreads < 1 || maxThreads > MAX_THREADS) {
+        printf("Usage: %s [maxThreads (1..%d)]\n", argv[0], MAX_THREADS);
+        return 1;
+    }
+
+    // Single-threaded walk-through.
+    TreiberStack stack;
+    initStack(&stack, 4, 1);
+    push(&stack, 10);
+    push(&stack, 20);
+    push(&stack, 30);
+    printStack(&stack);
+    int value;
+    pop(&stack, &value);
+    printf("Popped element: %d\n", value);
+    push(&stack, 40);
+    push(&stack, 50);
+    printf("Push 60 into a full stack: %s\n", push(&stack, 60) ? "pushed" : "no free node");
+    printStack(&stack);
+    while (pop(&stack, &value)) {
+    }
+    printf("Pop on an empty stack: %s\n\n", pop(&stack, &value) ? "popped" : "empty");
+    destroyStack(&stack);
+
+    stressTest(maxThreads, 200000);
+    benchmark(maxThreads, 500000);
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "genericStack.h"
+
+/*
+ * 17-persistentStack.c: A persistent (immutable) stack for backtracking search.
+ * Explanation: A version of the stack is just a pointer to its top node. Pushing creates one new
+ * node that points at the old top, and popping returns the version that starts at the next node,
+ * so both are O(1) and never change an existing version. Versions share all their common nodes,
+ * which makes a snapshot free: keeping an old version around is enough. Nodes are reference
+ * counted; a node is freed when the last version (or node above it) that uses it is released.
+ * Compile with -DUSE_NODE_POOL to take nodes from the slab allocator in nodePool.h, which also
+ * lets a whole search be reclaimed at once with poolReleaseAll.
+ * The benchmark runs the same deep search with the persistent stack and with the array stack of
+ * 05, which has to copy its whole items array at every branch.
+ * Usage: ./persistentStack [depth] [sideDepth]
+ */
+
+// Shared stack node. A node is never modified after it is created, except for its count.
+typedef struct PNode {
+    int data;               // Value stored in the node.
+    int refCount;           // Versions and nodes above that point to this node.
+    struct PNode* next;     // Node below, NULL at the bottom.
+} PNode;
+
+// A version of the persistent stack. Each PStack value owns one reference to its top node.
+typedef struct {
+    PNode* top;             // Top node, NULL for the empty stack.
+    int size;               // Number of elements in this version.
+} PStack;
+
+/*
+ * Node allocation: Compile with -DUSE_NODE_POOL to take nodes from the slab allocator
+ * in nodePool.h instead of calling malloc/free for every node.
+ */
+#ifdef USE_NODE_POOL
+#include "nodePool.h"
+static NodePool nodePool = NODE_POOL_INITIALIZER(sizeof(PNode));
+#endif
+
+static long long liveNodes = 0;  // Nodes currently allocated, for the reports.
+
+/*
+ * createNode / freeNode: Allocate and release one node.
+ */
+PNode* createNode(int data, PNode* next) {
+#ifdef USE_NODE_POOL
+    PNode* node = (PNode*)poolAlloc(&nodePool);
+#else
+    PNode* node = (PNode*)malloc(sizeof(PNode));
+#endif
+    if (node == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    node->data = data;
+    node->refCount = 1;
+    node->next = next;
+    liveNodes++;
+    return node;
+}
+
+void freeNode(PNode* node) {
+#ifdef USE_NODE_POOL
+    poolFree(&nodePool, node);
+#else
+    free(node);
+#endif
+    liveNodes--;
+}
+
+/*
+ * emptyStack: Returns the empty version. It owns no node, so it never needs releasing.
+ */
+PStack emptyStack(void) {
+    PStack s = { NULL, 0 };
+    return s;
+}
+
+/*
+ * retainStack: Takes a snapshot of a version in O(1).
+ * Explanation: The snapshot shares every node with s; only the top node's count changes.
+ * Every snapshot must be released with releaseStack.
+ */
+PStack retainStack(PStack s) {
+    if (s.top != NULL) {
+        s.top->refCount++;
+    }
+    return s;
+}
+
+/*
+ * releaseStack: Gives up a version.
+ * Explanation: The top node's count drops by one. A node whose count reaches zero is freed and
+ * its reference to the node below is given up in turn, so releasing the last version of a long
+ * private tail frees the tail in one loop, while nodes still shared with other versions stay.
+ */
+void releaseStack(PStack s) {
+    PNode* node = s.top;
+    while (node != NULL && --node->refCount == 0) {
+        PNode* next = node->next;
+        freeNode(node);
+        node = next;
+    }
+}
+
+/*
+ * persistentPush: Returns a new version with value on top of s. s itself is unchanged and
+ * stays valid; the new version must be released on its own.
+ */
+PStack persistentPush(PStack s, int value) {
+    if (s.top != NULL) {
+        s.top->refCount++;       // The new node refers to the old top.
+    }
+    PStack pushed = { createNode(value, s.top), s.size + 1 };
+    return pushed;
+}
+
+/*
+ * persistentPop: Stores the top value of s in *value and returns the version below it.
+ * Explanation: s is unchanged and stays valid; the returned version must be released on its own.
+ * Popping the empty stack prints "Stack underflow" and exits, like pop in 05.
+ */
+PStack persistentPop(PStack s, int* value) {
+    if (s.top == NULL) {
+        printf("Stack underflow\n");
+        exit(1);
+    }
+    *value = s.top->data;
+    PStack below = { s.top->next, s.size - 1 };
+    return retainStack(below);
+}
+
+/*
+ * persistentPeek: Returns the top value of s.
+ */
+int persistentPeek(PStack s) {
+    if (s.top == NULL) {
+        printf("Stack underflow\n");
+        exit(1);
+    }
+    return s.top->data;
+}
+
+/*
+ * printVersion: Prints a version from top to bottom.
+ */
+void printVersion(const char* name, PStack s) {
+    printf("%s (size %d): ", name, s.size);
+    for (PNode* node = s.top; node != NULL; node = node->next) {
+        printf("%d ", node->data);
+    }
+    printf("\n");
+}
+
+/*
+ * The array stack of 05, used by the copy-on-branch search.
+ */
+DEFINE_STACK(Stack, int, , 16)
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Shape of the search tree: a deep main line where every node branches. Each node with r levels
+// left below it has two children: the first continues with r - 1 levels, the second explores a
+// short side subtree of at most sideDepth levels (a dead end, as after pruning).
+#define BRANCH_FACTOR 2
+#define LEAF_WINDOW 4          // Top elements a leaf looks at.
+
+static long long copiedElements = 0;  // Elements copied by the copy-on-branch search.
+
+/*
+ * leafScore: What a leaf computes from the path: the sum of its top elements and the depth.
+ */
+long long leafScorePersistent(PStack path) {
+    long long score = path.size;
+    PNode* node = path.top;
+    for (int i = 0; i < LEAF_WINDOW && node != NULL; i++, node = node->next) {
+        score += node->data;
+    }
+    return score;
+}
+
+long long leafScoreArray(Stack* path) {
+    long long score = size(path);
+    for (int i = path->top; i >= 0 && i > path->top - LEAF_WINDOW; i--) {
+        score += path->items[i];
+    }
+    return score;
+}
+
+/*
+ * childLevels: Levels left below child c of a node with levels left below it.
+ */
+static inline int childLevels(int c, int levels, int sideDepth) {
+    return c == 0 || levels - 1 < sideDepth ? levels - 1 : sideDepth;
+}
+
+/*
+ * searchPersistent: Depth-first search where every child gets its own version of the path.
+ * Explanation: A child is one persistentPush away from its parent, so branching costs O(1) and
+ * the parent's path is still intact when the next child is tried.
+ */
+long long searchPersistent(PStack path, int levels, int sideDepth) {
+    if (levels == 0) {
+        return leafScorePersistent(path);
+    }
+    long long total = 0;
+    for (int c = 0; c < BRANCH_FACTOR; c++) {
+        PStack child = persistentPush(path, path.size * BRANCH_FACTOR + c);
+        total += searchPersistent(child, childLevels(c, levels, sideDepth), sideDepth);
+        releaseStack(child);
+    }
+    return total;
+}
+
+/*
+ * searchCopy: The same search with the array stack, copying the path at every branch.
+ * Explanation: Every child but the last gets a fresh copy of the whole path, since its subtree may
+ * change the stack before the search comes back; the last child reuses the parent's stack and
+ * pops its element again afterwards.
+ */
+long long searchCopy(Stack* path, int levels, int sideDepth) {
+    if (levels == 0) {
+        return leafScoreArray(path);
+    }
+    long long total = 0;
+    int depth = size(path);
+    for (int c = 0; c < BRANCH_FACTOR - 1; c++) {
+        Stack child;
+        initStack(&child);
+        pushMany(&child, path->items, depth);   // Snapshot: copy the whole path.
+        copiedElements += depth;
+        push(&child, depth * BRANCH_FACTOR + c);
+        total += searchCopy(&child, childLevels(c, levels, sideDepth), sideDepth);
+        freeStack(&child);
+    }
+    push(path, depth * BRANCH_FACTOR + BRANCH_FACTOR - 1);
+    total += searchCopy(path, childLevels(BRANCH_FACTOR - 1, levels, sideDepth), sideDepth);
+    pop(path);
+    return total;
+}
+
+/*
+ * benchmarkSearch: Runs both searches over the same tree and compares time and result.
+ */
+void benchmarkSearch(int maxDepth, int sideDepth) {
+    printf("Search tree: main line of depth %d, every node branches, side subtrees of depth %d\n",
+           maxDepth, sideDepth);
+
+    double start = nowSeconds();
+    long long persistentResult = searchPersistent(emptyStack(), maxDepth, sideDepth);
+    double persistentTime = nowSeconds() - start;
+
+    Stack path;
+    initStack(&path);
+    start = nowSeconds();
+    long long copyResult = searchCopy(&path, maxDepth, sideDepth);
+    double copyTime = nowSeconds() - start;
+    freeStack(&path);
+
+    printf("  persistent stack : %9.2f ms\n", persistentTime * 1e3);
+    printf("  copy-on-branch   : %9.2f ms  (%lld elements copied)\n", copyTime * 1e3, copiedElements);
+    printf("  results %s, nodes left after the search: %lld\n",
+           persistentResult == copyResult ? "match" : "DIFFER", liveNodes);
+}
+
+// Main function to demonstrate versions and snapshots and run the search benchmark.
+int main(int argc, char* argv[]) {
+    int maxDepth = argc > 1 ? atoi(argv[1]) : 4096;
+    int sideDepth = argc > 2 ? atoi(argv[2]) : 6;
+    if (maxDepth <= 0 || sideDepth < 0 || sideDepth > 20) {
+        printf("Usage: %s [depth] [sideDepth (0..20)]\n", argv[0]);
+        return 1;
+    }
+
+    // Versions share their common nodes.
+    PStack a = persistentPush(emptyStack(), 10);
+    PStack b = persistentPush(a, 20);
+    PStack c = persistentPush(b, 30);
+    PStack snapshot = retainStack(c);            // O(1) snapshot
+    int value;
+    PStack d = persistentPop(c, &value);         // c itself is unchanged
+    PStack e = persistentPush(d, 40);            // shares 20 and 10 with c
+    printVersion("a", a);
+    printVersion("c", c);
+    printVersion("snapshot of c", snapshot);
+    printf("Popped %d from c, then pushed 40:\n", value);
+    printVersion("e", e);
+    printf("Nodes allocated for 6 versions: %lld\n", liveNodes);
+    releaseStack(a);
+    releaseStack(b);
+    releaseStack(c);
+    releaseStack(d);
+    releaseStack(e);
+    printf("After releasing all but the snapshot: %lld nodes\n", liveNodes);
+    releaseStack(snapshot);
+    printf("After releasing the snapshot: %lld nodes\n\n", liveNodes);
+
+    benchmarkSearch(maxDepth, sideDepth);
+#ifdef USE_NODE_POOL
+    poolDestroy(&nodePool); // Release the pool's slabs in one call.
+#endif
+    return 0;
+}
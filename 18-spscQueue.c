@@ -0,0 +1,370 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+
+/*
+ * 18-spscQueue.c: A bounded lock-free queue between exactly one producer thread and one consumer
+ * thread, for connecting the stages of a pipeline.
+ * Explanation: The queue is the ring buffer of 07 with a fixed power-of-two capacity. Only the
+ * producer writes tail and only the consumer writes head, so no compare-and-swap is needed: the
+ * producer stores an element and then publishes it with a release store of tail, and the consumer
+ * reads tail with an acquire load before it reads the element (and the same the other way round
+ * for freed slots). The two indices live on separate cache lines so that the threads do not keep
+ * stealing one line from each other. Each side also keeps a private copy of the other side's
+ * index and reads the shared one only when its copy says the queue is full (producer) or empty
+ * (consumer); most operations touch no line the other thread writes. The batch operations move
+ * many elements with at most two memcpys and a single release store.
+ * The benchmark pins the producer and the consumer to different cores and measures throughput
+ * (single and batch operations) and round-trip latency.
+ * Usage: ./spscQueue [producerCore] [consumerCore]
+ */
+
+#define CACHE_LINE 64           // Bytes per cache line.
+#define SPIN_LIMIT 256          // Failed attempts before a waiting thread yields its core.
+
+// SPSC queue. The first two groups of fields are each written by one thread only.
+typedef struct {
+    // Producer's cache line.
+    _Alignas(CACHE_LINE) _Atomic(uint32_t) tail;    // Position of the next element to store.
+    uint32_t cachedHead;                            // Producer's last copy of head.
+    // Consumer's cache line.
+    _Alignas(CACHE_LINE) _Atomic(uint32_t) head;    // Position of the next element to take.
+    uint32_t cachedTail;                            // Consumer's last copy of tail.
+    // Read-only after initQueue.
+    _Alignas(CACHE_LINE) int* items;                // Ring of capacity elements.
+    uint32_t capacity;                              // A power of two.
+    uint32_t mask;                                  // capacity - 1.
+} SpscQueue;
+
+/*
+ * initQueue / destroyQueue: Set up an empty queue for capacity elements (rounded up to a power of
+ * two) and release it.
+ */
+void initQueue(SpscQueue* q, uint32_t capacity) {
+    uint32_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    q->items = (int*)malloc((size_t)size * sizeof(int));
+    if (q->items == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    q->capacity = size;
+    q->mask = size - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->cachedHead = 0;
+    q->cachedTail = 0;
+}
+
+void destroyQueue(SpscQueue* q) {
+    free(q->items);
+    q->items = NULL;
+}
+
+/*
+ * tryEnqueue: Adds value at the tail. Producer only.
+ * Returns 1 on success and 0 if the queue is full.
+ */
+static inline int tryEnqueue(SpscQueue* q, int value) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);  // Own index.
+    if (tail - q->cachedHead == q->capacity) {
+        // Full according to the copy: look at the real head, which acquires the freed slots.
+        q->cachedHead = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail - q->cachedHead == q->capacity) {
+            return 0;
+        }
+    }
+    q->items[tail & q->mask] = value;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);       // Publish it.
+    return 1;
+}
+
+/*
+ * tryDequeue: Takes the element at the head into *value. Consumer only.
+ * Returns 1 on success and 0 if the queue is empty.
+ */
+static inline int tryDequeue(SpscQueue* q, int* value) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (head == q->cachedTail) {
+        q->cachedTail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head == q->cachedTail) {
+            return 0;
+        }
+    }
+    *value = q->items[head & q->mask];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);       // Free the slot.
+    return 1;
+}
+
+/*
+ * enqueueMany: Adds up to count values at the tail. Producer only.
+ * Returns how many were added, which is less than count when the queue fills up.
+ */
+static inline int enqueueMany(SpscQueue* q, const int* values, int count) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t space = q->capacity - (tail - q->cachedHead);
+    if (space < (uint32_t)count) {
+        q->cachedHead = atomic_load_explicit(&q->head, memory_order_acquire);
+        space = q->capacity - (tail - q->cachedHead);
+    }
+    uint32_t n = (uint32_t)count < space ? (uint32_t)count : space;
+    uint32_t start = tail & q->mask;
+    uint32_t first = q->capacity - start < n ? q->capacity - start : n;
+    memcpy(q->items + start, values, first * sizeof(int));
+    memcpy(q->items, values + first, (n - first) * sizeof(int));
+    atomic_store_explicit(&q->tail, tail + n, memory_order_release);
+    return (int)n;
+}
+
+/*
+ * dequeueMany: Takes up to count elements from the head into values. Consumer only.
+ * Returns how many were taken, 0 if the queue is empty.
+ */
+static inline int dequeueMany(SpscQueue* q, int* values, int count) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t available = q->cachedTail - head;
+    if (available < (uint32_t)count) {
+        q->cachedTail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        available = q->cachedTail - head;
+    }
+    uint32_t n = (uint32_t)count < available ? (uint32_t)count : available;
+    uint32_t start = head & q->mask;
+    uint32_t first = q->capacity - start < n ? q->capacity - start : n;
+    memcpy(values, q->items + start, first * sizeof(int));
+    memcpy(values + first, q->items, (n - first) * sizeof(int));
+    atomic_store_explicit(&q->head, head + n, memory_order_release);
+    return (int)n;
+}
+
+/*
+ * backoff: Called after a failed attempt. Spins at first and yields the core after SPIN_LIMIT
+ * failures, so a waiting thread does not hold up the other one when they share a core.
+ */
+static inline void backoff(int* failures) {
+    if (++*failures >= SPIN_LIMIT) {
+        sched_yield();
+        *failures = 0;
+    }
+}
+
+// enqueueWait / dequeueWait: Retry until the operation succeeds.
+static inline void enqueueWait(SpscQueue* q, int value) {
+    int failures = 0;
+    while (!tryEnqueue(q, value)) {
+        backoff(&failures);
+    }
+}
+
+static inline int dequeueWait(SpscQueue* q) {
+    int value, failures = 0;
+    while (!tryDequeue(q, &value)) {
+        backoff(&failures);
+    }
+    return value;
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * pinToCore: Binds the calling thread to one core. Returns 0 on success.
+ */
+int pinToCore(int core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Arguments of the benchmark threads.
+typedef struct {
+    SpscQueue* queue;           // Producer to consumer.
+    SpscQueue* reply;           // Consumer back to producer, for the latency test.
+    int core;                   // Core to pin the thread to.
+    long long items;            // Elements to move.
+    int batch;                  // Elements per enqueueMany/dequeueMany, 1 for single operations.
+    long long sum;              // Consumer: sum of everything received, to check the transfer.
+    double* samples;            // Producer: round-trip times of the latency test.
+} BenchArgs;
+
+void* producerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    pinToCore(a->core);
+    if (a->batch == 1) {
+        for (long long i = 0; i < a->items; i++) {
+            enqueueWait(a->queue, (int)i);
+        }
+        return NULL;
+    }
+    int* values = (int*)malloc(a->batch * sizeof(int));
+    long long next = 0;
+    int failures = 0;
+    while (next < a->items) {
+        int count = a->items - next < a->batch ? (int)(a->items - next) : a->batch;
+        for (int i = 0; i < count; i++) {
+            values[i] = (int)(next + i);
+        }
+        int sent = 0;
+        while (sent < count) {
+            int n = enqueueMany(a->queue, values + sent, count - sent);
+            sent += n;
+            if (n == 0) {
+                backoff(&failures);
+            }
+        }
+        next += count;
+    }
+    free(values);
+    return NULL;
+}
+
+void* consumerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    pinToCore(a->core);
+    long long sum = 0;
+    if (a->batch == 1) {
+        for (long long i = 0; i < a->items; i++) {
+            sum += dequeueWait(a->queue);
+        }
+    } else {
+        int* values = (int*)malloc(a->batch * sizeof(int));
+        long long received = 0;
+        int failures = 0;
+        while (received < a->items) {
+            int n = dequeueMany(a->queue, values, a->batch);
+            for (int i = 0; i < n; i++) {
+                sum += values[i];
+            }
+            received += n;
+            if (n == 0) {
+                backoff(&failures);
+            }
+        }
+        free(values);
+    }
+    a->sum = sum;
+    return NULL;
+}
+
+/*
+ * benchmarkThroughput: Moves items elements from a producer to a consumer thread.
+ */
+void benchmarkThroughput(int producerCore, int consumerCore, long long items, int batch) {
+    SpscQueue queue;
+    initQueue(&queue, 4096);
+    BenchArgs producer = { &queue, NULL, producerCore, items, batch, 0, NULL };
+    BenchArgs consumer = { &queue, NULL, consumerCore, items, batch, 0, NULL };
+    pthread_t threads[2];
+    double start = nowSeconds();
+    pthread_create(&threads[0], NULL, producerThread, &producer);
+    pthread_create(&threads[1], NULL, consumerThread, &consumer);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    double elapsed = nowSeconds() - start;
+    long long expected = items * (items - 1) / 2;
+    printf("  batch %4d : %8.1f M elements/s  (%s)\n", batch, items / elapsed / 1e6,
+           consumer.sum == expected ? "all received" : "LOST ELEMENTS");
+    destroyQueue(&queue);
+}
+
+// echoThread: Sends every element it receives straight back.
+void* echoThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    pinToCore(a->core);
+    for (long long i = 0; i < a->items; i++) {
+        enqueueWait(a->reply, dequeueWait(a->queue));
+    }
+    return NULL;
+}
+
+// pingThread: Sends one element at a time and times how long its echo takes to come back.
+void* pingThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    pinToCore(a->core);
+    for (long long i = 0; i < a->items; i++) {
+        double start = nowSeconds();
+        enqueueWait(a->queue, (int)i);
+        dequeueWait(a->reply);
+        a->samples[i] = nowSeconds() - start;
+    }
+    return NULL;
+}
+
+static int compareDoubles(const void* x, const void* y) {
+    double a = *(const double*)x, b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+/*
+ * benchmarkLatency: Measures round trips through two queues, producer -> consumer -> producer.
+ */
+void benchmarkLatency(int producerCore, int consumerCore, long long rounds) {
+    SpscQueue there, back;
+    initQueue(&there, 64);
+    initQueue(&back, 64);
+    double* samples = (double*)malloc(rounds * sizeof(double));
+    if (samples == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    BenchArgs ping = { &there, &back, producerCore, rounds, 1, 0, samples };
+    BenchArgs echo = { &there, &back, consumerCore, rounds, 1, 0, NULL };
+    pthread_t threads[2];
+    pthread_create(&threads[0], NULL, pingThread, &ping);
+    pthread_create(&threads[1], NULL, echoThread, &echo);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    qsort(samples, rounds, sizeof(double), compareDoubles);
+    printf("  round trip : median %.0f ns, 99th percentile %.0f ns, max %.0f ns\n",
+           samples[rounds / 2] * 1e9, samples[rounds * 99 / 100] * 1e9, samples[rounds - 1] * 1e9);
+    free(samples);
+    destroyQueue(&there);
+    destroyQueue(&back);
+}
+
+// Main function to demonstrate the queue and run the benchmarks.
+int main(int argc, char* argv[]) {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int producerCore = argc > 1 ? atoi(argv[1]) : 0;
+    int consumerCore = argc > 2 ? atoi(argv[2]) : (cores > 1 ? 1 : 0);
+    if (producerCore < 0 || consumerCore < 0 || producerCore >= cores || consumerCore >= cores) {
+        printf("Usage: %s [producerCore] [consumerCore] (cores 0..%d)\n", argv[0], cores - 1);
+        return 1;
+    }
+
+    // Single-threaded walk-through.
+    SpscQueue q;
+    initQueue(&q, 4);
+    int values[6] = { 10, 20, 30, 40, 50, 60 }, out[6], value;
+    printf("Enqueued %d of 6 values into a queue of capacity %u\n", enqueueMany(&q, values, 6), q.capacity);
+    tryDequeue(&q, &value);
+    printf("Dequeued %d, enqueue 50: %s\n", value, tryEnqueue(&q, 50) ? "ok" : "full");
+    int n = dequeueMany(&q, out, 6);
+    printf("Dequeued %d values:", n);
+    for (int i = 0; i < n; i++) {
+        printf(" %d", out[i]);
+    }
+    printf("\nDequeue from the empty queue: %s\n\n", tryDequeue(&q, &value) ? "ok" : "empty");
+    destroyQueue(&q);
+
+    printf("Producer on core %d, consumer on core %d%s\n", producerCore, consumerCore,
+           producerCore == consumerCore ? " (same core: the threads take turns)" : "");
+    printf("Throughput, 20M elements:\n");
+    benchmarkThroughput(producerCore, consumerCore, 20000000, 1);
+    benchmarkThroughput(producerCore, consumerCore, 20000000, 64);
+    printf("Latency, 100000 round trips:\n");
+    benchmarkLatency(producerCore, consumerCore, 100000);
+    return 0;
+}
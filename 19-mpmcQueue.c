@@ -0,0 +1,474 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include "ringQueue.h"
+
+/*
+ * 19-mpmcQueue.c: A bounded queue that any number of producer and consumer threads can share,
+ * for fan-in and fan-out between pipeline stages.
+ * Explanation: The queue is a ring of cells, and every cell carries a sequence number that says
+ * whose turn it is (Dmitry Vyukov's design):
+ *   - cell i starts with sequence i: free for the enqueue at position i;
+ *   - an enqueue at position p claims it by advancing enqueuePos from p to p + 1 with one CAS,
+ *     stores the value and sets the sequence to p + 1: full, ready for the dequeue at position p;
+ *   - a dequeue at position p claims it the same way through dequeuePos, takes the value and sets
+ *     the sequence to p + capacity: free for the enqueue one lap later.
+ * So every operation is one CAS on one of the two positions plus plain loads and stores on its
+ * cell, and there is no lock. The sequence also tells a thread that the queue is full or empty
+ * without looking at the other position.
+ * The blocking operations spin briefly and then sleep on a futex, so a thread that waits for a
+ * long time costs no CPU. A sleeper arms its wait point first; the other side makes a system call
+ * only when it finds the wait point armed, and then wakes every sleeper at once, so a burst of
+ * operations while a thread sleeps costs one wake-up, not one per operation.
+ * The benchmark compares the queue with the ring buffer queue of 07 (ringQueue.h) behind a mutex
+ * and two condition variables, for 1 to maxThreads threads.
+ * Usage: ./mpmcQueue [maxThreads]
+ */
+
+#define CACHE_LINE 64           // Bytes per cache line.
+#define MAX_THREADS 64          // Upper bound on threads in the benchmark.
+#define SPIN_LIMIT 64           // Failed attempts before a blocking operation goes to sleep.
+
+// One cell of the ring.
+typedef struct {
+    _Atomic(uint32_t) sequence; // Whose turn it is, see above.
+    int data;                   // Value stored in the cell.
+} Cell;
+
+// A place where threads sleep until the queue changes in their favour.
+typedef struct {
+    _Atomic(uint32_t) epoch;    // Futex word, incremented by every wake-up.
+    atomic_int armed;           // 1 if a thread may be asleep on epoch.
+} WaitPoint;
+
+typedef struct {
+    _Alignas(CACHE_LINE) _Atomic(uint32_t) enqueuePos;  // Next position to enqueue at.
+    _Alignas(CACHE_LINE) _Atomic(uint32_t) dequeuePos;  // Next position to dequeue from.
+    _Alignas(CACHE_LINE) Cell* cells;                   // Ring of capacity cells.
+    uint32_t capacity;                                  // A power of two.
+    uint32_t mask;                                      // capacity - 1.
+    _Alignas(CACHE_LINE) WaitPoint notEmpty;            // Consumers waiting for an element.
+    _Alignas(CACHE_LINE) WaitPoint notFull;             // Producers waiting for a free cell.
+    atomic_llong sleeps;                                // Times a thread went to sleep.
+} MpmcQueue;
+
+/*
+ * initQueue / destroyQueue: Set up an empty queue for capacity elements (rounded up to a power of
+ * two) and release it.
+ */
+void initQueue(MpmcQueue* q, uint32_t capacity) {
+    uint32_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    q->cells = (Cell*)malloc((size_t)size * sizeof(Cell));
+    if (q->cells == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        atomic_init(&q->cells[i].sequence, i);
+    }
+    q->capacity = size;
+    q->mask = size - 1;
+    atomic_init(&q->enqueuePos, 0);
+    atomic_init(&q->dequeuePos, 0);
+    atomic_init(&q->notEmpty.epoch, 0);
+    atomic_init(&q->notEmpty.armed, 0);
+    atomic_init(&q->notFull.epoch, 0);
+    atomic_init(&q->notFull.armed, 0);
+    atomic_init(&q->sleeps, 0);
+}
+
+void destroyQueue(MpmcQueue* q) {
+    free(q->cells);
+    q->cells = NULL;
+}
+
+// futexWait / futexWake: Sleep while *word == expected; wake up to count sleepers on word.
+static void futexWait(_Atomic(uint32_t)* word, uint32_t expected) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futexWake(_Atomic(uint32_t)* word, int count) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+/*
+ * wakeAll: Called after an operation that may let a sleeper continue.
+ * Explanation: The fence orders the operation before the look at armed. A sleeper arms the wait
+ * point and then makes one last attempt (prepareWait), so either that attempt sees this change
+ * or this sees the wait point armed. Disarming it with an exchange lets only one thread make the
+ * system call; in the common case nobody sleeps and no system call is made at all.
+ */
+static inline void wakeAll(WaitPoint* w) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&w->armed, memory_order_relaxed) && atomic_exchange(&w->armed, 0)) {
+        atomic_fetch_add_explicit(&w->epoch, 1, memory_order_release);
+        futexWake(&w->epoch, INT_MAX);
+    }
+}
+
+/*
+ * prepareWait: Arms a wait point before a thread's last attempt and returns the epoch to sleep on.
+ * Explanation: If anything changes after this, the epoch changes too and the futex call returns
+ * at once instead of missing the wake-up.
+ */
+static inline uint32_t prepareWait(WaitPoint* w) {
+    uint32_t epoch = atomic_load_explicit(&w->epoch, memory_order_acquire);
+    atomic_store(&w->armed, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    return epoch;
+}
+
+/*
+ * tryEnqueue: Adds value to the queue. Returns 1 on success and 0 if the queue is full.
+ * A consumer asleep in dequeueWait is woken, so try and blocking calls can be mixed freely.
+ */
+int tryEnqueue(MpmcQueue* q, int value) {
+    uint32_t pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        uint32_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - pos);
+        if (diff == 0) {
+            // The cell is free for position pos: claim it. On failure pos is reloaded.
+            if (atomic_compare_exchange_weak_explicit(&q->enqueuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;   // The cell still holds the element from one lap ago: full.
+        } else {
+            pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);   // Overtaken.
+        }
+    }
+    cell->data = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    wakeAll(&q->notEmpty);
+    return 1;
+}
+
+/*
+ * tryDequeue: Takes the oldest element into *value. Returns 1 on success and 0 if the queue is empty.
+ * A producer asleep in enqueueWait is woken.
+ */
+int tryDequeue(MpmcQueue* q, int* value) {
+    uint32_t pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        uint32_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;   // Nothing has been stored at position pos yet: empty.
+        } else {
+            pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+        }
+    }
+    *value = cell->data;
+    atomic_store_explicit(&cell->sequence, pos + q->mask + 1, memory_order_release);
+    wakeAll(&q->notFull);
+    return 1;
+}
+
+/*
+ * enqueueWait: Adds value to the queue, waiting while it is full.
+ * Explanation: The producer spins for SPIN_LIMIT attempts, then arms notFull, tries once more and
+ * sleeps until a consumer frees a cell.
+ */
+void enqueueWait(MpmcQueue* q, int value) {
+    for (int attempt = 0; !tryEnqueue(q, value); attempt++) {
+        if (attempt < SPIN_LIMIT) {
+            continue;
+        }
+        uint32_t epoch = prepareWait(&q->notFull);
+        if (tryEnqueue(q, value)) {
+            break;
+        }
+        atomic_fetch_add_explicit(&q->sleeps, 1, memory_order_relaxed);
+        futexWait(&q->notFull.epoch, epoch);
+        attempt = 0;
+    }
+}
+
+/*
+ * dequeueWait: Takes the oldest element, waiting while the queue is empty.
+ */
+int dequeueWait(MpmcQueue* q) {
+    int value;
+    for (int attempt = 0; !tryDequeue(q, &value); attempt++) {
+        if (attempt < SPIN_LIMIT) {
+            continue;
+        }
+        uint32_t epoch = prepareWait(&q->notEmpty);
+        if (tryDequeue(q, &value)) {
+            break;
+        }
+        atomic_fetch_add_explicit(&q->sleeps, 1, memory_order_relaxed);
+        futexWait(&q->notEmpty.epoch, epoch);
+        attempt = 0;
+    }
+    return value;
+}
+
+/*
+ * LockedQueue: The baseline, the 07 queue behind one mutex, bounded to the same capacity.
+ */
+typedef struct {
+    Queue* queue;
+    int capacity;
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+} LockedQueue;
+
+void initLockedQueue(LockedQueue* q, int capacity) {
+    q->queue = createQueue();
+    reserve(q->queue, (unsigned int)capacity);
+    q->capacity = capacity;
+    pthread_mutex_init(&q->mutex, NULL);
+    pthread_cond_init(&q->notEmpty, NULL);
+    pthread_cond_init(&q->notFull, NULL);
+}
+
+void lockedEnqueue(LockedQueue* q, int value) {
+    pthread_mutex_lock(&q->mutex);
+    while (size(q->queue) == q->capacity) {
+        pthread_cond_wait(&q->notFull, &q->mutex);
+    }
+    enqueue(q->queue, value);
+    pthread_cond_signal(&q->notEmpty);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+int lockedDequeue(LockedQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    while (isEmpty(q->queue)) {
+        pthread_cond_wait(&q->notEmpty, &q->mutex);
+    }
+    int value = dequeue(q->queue);
+    pthread_cond_signal(&q->notFull);
+    pthread_mutex_unlock(&q->mutex);
+    return value;
+}
+
+void destroyLockedQueue(LockedQueue* q) {
+    freeQueue(q->queue);
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->notEmpty);
+    pthread_cond_destroy(&q->notFull);
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Arguments of a benchmark thread. Values are (producer << 24) | sequence number.
+typedef struct {
+    MpmcQueue* mpmc;            // Queue under test, or NULL to use locked.
+    LockedQueue* locked;
+    int id;                     // Producer number, or -1 for a consumer.
+    int producers;              // Number of producers, so a consumer can check the order.
+    int count;                  // Elements this thread enqueues or dequeues.
+    long long sum;              // Consumer: sum of the sequence numbers received.
+    int outOfOrder;             // Consumer: elements that arrived before an earlier one of the same producer.
+} BenchArgs;
+
+void* producerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    for (int i = 0; i < a->count; i++) {
+        int value = a->id << 24 | i;
+        if (a->mpmc != NULL) {
+            enqueueWait(a->mpmc, value);
+        } else {
+            lockedEnqueue(a->locked, value);
+        }
+    }
+    return NULL;
+}
+
+void* consumerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    int last[MAX_THREADS];
+    for (int p = 0; p < a->producers; p++) {
+        last[p] = -1;
+    }
+    for (int i = 0; i < a->count; i++) {
+        int value = a->mpmc != NULL ? dequeueWait(a->mpmc) : lockedDequeue(a->locked);
+        int producer = value >> 24, sequence = value & 0xFFFFFF;
+        if (sequence <= last[producer]) {
+            a->outOfOrder++;    // A FIFO queue delivers each producer's elements in order.
+        }
+        last[producer] = sequence;
+        a->sum += sequence;
+    }
+    return NULL;
+}
+
+/*
+ * runBenchmark: Moves items elements through one queue with threads threads, half producers and
+ * half consumers (one of each for threads == 1, which then take turns on the same core).
+ * Returns the elapsed time, or a negative value if an element was lost or reordered.
+ */
+double runBenchmark(MpmcQueue* mpmc, LockedQueue* locked, int threads, int items) {
+    int producers = threads > 1 ? threads / 2 : 1;
+    int consumers = threads > 1 ? threads - producers : 1;
+    int perProducer = items / producers;
+    items = perProducer * producers;
+    BenchArgs args[2 * MAX_THREADS];
+    pthread_t handles[2 * MAX_THREADS];
+    double start = nowSeconds();
+    for (int t = 0; t < producers + consumers; t++) {
+        BenchArgs a = { mpmc, locked, t < producers ? t : -1, producers, 0, 0, 0 };
+        if (t < producers) {
+            a.count = perProducer;
+        } else {
+            int c = t - producers;      // Spread items over the consumers.
+            a.count = items / consumers + (c < items % consumers ? 1 : 0);
+        }
+        args[t] = a;
+        pthread_create(&handles[t], NULL, t < producers ? producerThread : consumerThread, &args[t]);
+    }
+    long long sum = 0;
+    int outOfOrder = 0;
+    for (int t = 0; t < producers + consumers; t++) {
+        pthread_join(handles[t], NULL);
+        sum += args[t].sum;
+        outOfOrder += args[t].outOfOrder;
+    }
+    double elapsed = nowSeconds() - start;
+    long long expected = (long long)producers * perProducer * (perProducer - 1) / 2;
+    return sum == expected && outOfOrder == 0 ? elapsed : -1;
+}
+
+// Threads for checkMixedCalls: each blocks once and records what it got in mixedResult.
+static atomic_llong mixedResult;
+
+static void* blockedDequeuer(void* arg) {
+    atomic_store(&mixedResult, dequeueWait((MpmcQueue*)arg));
+    return NULL;
+}
+
+static void* blockedEnqueuer(void* arg) {
+    enqueueWait((MpmcQueue*)arg, 7);
+    atomic_store(&mixedResult, 7);
+    return NULL;
+}
+
+/*
+ * waitUntil: Polls for up to a second until *word reaches value. Returns 1 if it did.
+ */
+static int waitUntil(atomic_llong* word, long long value) {
+    for (int i = 0; i < 1000; i++) {
+        if (atomic_load(word) >= value) {
+            return 1;
+        }
+        struct timespec ts = { 0, 1000000 };
+        nanosleep(&ts, NULL);
+    }
+    return 0;
+}
+
+/*
+ * checkMixedCalls: A thread asleep in dequeueWait must be woken by tryEnqueue, and a thread asleep
+ * in enqueueWait by tryDequeue. Returns 1 if both threads finish in time with the right values;
+ * a thread that is never woken is left behind and the check fails.
+ */
+int checkMixedCalls(void) {
+    static MpmcQueue q;         // Static: a thread left asleep must not outlive its queue.
+    initQueue(&q, 2);
+    pthread_t thread;
+    atomic_store(&mixedResult, 0);
+    pthread_create(&thread, NULL, blockedDequeuer, &q);
+    waitUntil(&q.sleeps, 1);
+    tryEnqueue(&q, 42);
+    if (!waitUntil(&mixedResult, 42)) {
+        return 0;
+    }
+    pthread_join(thread, NULL);
+
+    tryEnqueue(&q, 1);
+    tryEnqueue(&q, 2);          // Full: the next enqueueWait has to sleep.
+    long long sleeps = atomic_load(&q.sleeps);
+    atomic_store(&mixedResult, 0);
+    pthread_create(&thread, NULL, blockedEnqueuer, &q);
+    waitUntil(&q.sleeps, sleeps + 1);
+    int value, ok = tryDequeue(&q, &value) && value == 1;
+    if (!waitUntil(&mixedResult, 7)) {
+        return 0;
+    }
+    pthread_join(thread, NULL);
+    ok &= tryDequeue(&q, &value) && value == 2;
+    ok &= tryDequeue(&q, &value) && value == 7;
+    destroyQueue(&q);
+    return ok;
+}
+
+/*
+ * benchmark: Compares both queues at 1, 2, 4, ... maxThreads threads.
+ */
+void benchmark(int maxThreads, int items, int capacity) {
+    printf("%d elements through a queue of capacity %d\n", items, capacity);
+    printf("threads   MPMC (M ops/s)   sleeps   mutex+condvar (M ops/s)\n");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        MpmcQueue mpmc;
+        LockedQueue locked;
+        initQueue(&mpmc, capacity);
+        initLockedQueue(&locked, capacity);
+        double mpmcTime = runBenchmark(&mpmc, NULL, threads, items);
+        double lockedTime = runBenchmark(NULL, &locked, threads, items);
+        printf("%7d   %14.2f   %6lld   %23.2f", threads, items / mpmcTime / 1e6,
+               (long long)atomic_load(&mpmc.sleeps), items / lockedTime / 1e6);
+        printf("%s\n", mpmcTime < 0 || lockedTime < 0 ? "   LOST OR REORDERED ELEMENTS" : "");
+        destroyQueue(&mpmc);
+        destroyLockedQueue(&locked);
+        if (threads < maxThreads && threads * 2 > maxThreads) {
+            threads = maxThreads / 2;   // Make sure maxThreads itself is measured.
+        }
+    }
+}
+
+// Main function to demonstrate the queue and run the benchmark.
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : MAX_THREADS;
+    if (maxThreads < 1 || maxThreads > MAX_THREADS) {
+        printf("Usage: %s [maxThreads (1..%d)]\n", argv[0], MAX_THREADS);
+        return 1;
+    }
+
+    // Single-threaded walk-through.
+    MpmcQueue q;
+    initQueue(&q, 4);
+    int value, added = 0;
+    for (int i = 1; i <= 6; i++) {
+        added += tryEnqueue(&q, i * 10);
+    }
+    printf("Enqueued %d of 6 values into a queue of capacity %u\n", added, q.capacity);
+    printf("Dequeued:");
+    while (tryDequeue(&q, &value)) {
+        printf(" %d", value);
+    }
+    printf("\nDequeue from the empty queue: %s\n", tryDequeue(&q, &value) ? "ok" : "empty");
+    destroyQueue(&q);
+    printf("Sleeping consumer woken by tryEnqueue, producer by tryDequeue: %s\n\n",
+           checkMixedCalls() ? "ok" : "FAILED");
+
+    benchmark(maxThreads, 2000000, 1024);
+    return 0;
+}
@@ -0,0 +1,473 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "ringQueue.h"
+
+/*
+ * 20-blockingQueue.c: A bounded blocking queue for handing work to consumer threads.
+ * Explanation: dequeue in 07 returns INT_MIN when the queue is empty, so a consumer has to poll it
+ * in a loop and keeps a core busy while there is no work. This queue wraps the 07 queue
+ * (ringQueue.h) with a mutex and two condition variables:
+ *   - dequeueWait blocks until an element arrives, dequeueTimeout gives up after a timeout;
+ *   - enqueueWait blocks while the queue is full (back-pressure), so a fast producer is slowed
+ *     down to the speed of its consumers instead of growing the queue without bound;
+ *   - closeQueue tells both sides to stop: enqueues fail at once, dequeues first drain the
+ *     elements that are left and then fail, so no work is lost on shutdown.
+ * A thread that has to wait first spins for a while, reading the element count without the lock,
+ * because a wait that ends within a few microseconds is cheaper than going to sleep and being woken.
+ * The spin length adapts: it doubles when spinning paid off and halves when the thread had to sleep
+ * anyway, and it is 0 on a machine with one CPU, where spinning only delays the thread it waits for.
+ * A thread signals a condition variable only when a sleeper is still needed: after an enqueue only
+ * if there are no more elements than sleeping consumers (each earlier element already woke one),
+ * and the same for free slots and sleeping producers.
+ * The queue counts sleeps, wake-ups, spurious wake-ups, timeouts and how long sleepers waited.
+ * The demo compares a polling consumer with a blocking one on a bursty producer.
+ * Usage: ./blockingQueue [bursts]
+ */
+
+#define MIN_SPIN 16             // Shortest adaptive spin, in checks of the count.
+#define MAX_SPIN 4096           // Longest adaptive spin.
+
+// Result of an operation.
+typedef enum {
+    QUEUE_OK,                   // The element was enqueued or dequeued.
+    QUEUE_TIMEOUT,              // The timeout expired first.
+    QUEUE_CLOSED                // The queue was closed (and, for a dequeue, drained).
+} QueueStatus;
+
+// Counters, updated under the queue's mutex.
+typedef struct {
+    long long sleeps;           // Times a thread went to sleep on a condition variable.
+    long long wakeups;          // Signals sent to sleeping threads.
+    long long spuriousWakeups;  // Times a thread woke up and still had to wait.
+    long long spinHits;         // Waits that ended while spinning, without sleeping.
+    long long timeouts;         // Operations that gave up after their timeout.
+    long long waitedOperations; // Operations that slept at least once and then completed.
+    long long totalWaitNs;      // Time those operations spent between first sleep and completion.
+    long long maxWaitNs;        // Longest of those times.
+} QueueStats;
+
+typedef struct {
+    Queue* queue;               // The 07 queue, holding at most capacity elements.
+    int capacity;
+    int closed;                 // Set by closeQueue.
+    int sleepingConsumers;      // Threads asleep on notEmpty.
+    int sleepingProducers;      // Threads asleep on notFull.
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    atomic_int count;           // Copy of size(queue), read by spinning threads without the lock.
+    atomic_int spinLimit;       // Current adaptive spin length, 0 to never spin.
+    QueueStats stats;
+} BlockingQueue;
+
+/*
+ * initBlockingQueue / destroyBlockingQueue: Set up an empty queue for capacity elements and
+ * release it. The condition variables use CLOCK_MONOTONIC, so timeouts are not affected by changes
+ * of the wall clock.
+ */
+void initBlockingQueue(BlockingQueue* q, int capacity) {
+    q->queue = createQueue();
+    reserve(q->queue, (unsigned int)capacity);
+    q->capacity = capacity;
+    q->closed = 0;
+    q->sleepingConsumers = 0;
+    q->sleepingProducers = 0;
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&q->mutex, NULL);
+    pthread_cond_init(&q->notEmpty, &attr);
+    pthread_cond_init(&q->notFull, &attr);
+    pthread_condattr_destroy(&attr);
+    atomic_init(&q->count, 0);
+    atomic_init(&q->spinLimit, sysconf(_SC_NPROCESSORS_ONLN) > 1 ? MIN_SPIN : 0);
+    QueueStats zero = { 0 };
+    q->stats = zero;
+}
+
+void destroyBlockingQueue(BlockingQueue* q) {
+    freeQueue(q->queue);
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->notEmpty);
+    pthread_cond_destroy(&q->notFull);
+}
+
+long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline void cpuRelax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/*
+ * spinUntil: Spins until the queue holds at least one element (wantElement) or has a free slot
+ * (!wantElement), or the queue is closed, for at most the current spin limit.
+ * Returns 1 if the wait ended while spinning. The spin limit doubles on success and halves on
+ * failure, between MIN_SPIN and MAX_SPIN.
+ */
+static int spinUntil(BlockingQueue* q, int wantElement) {
+    int limit = atomic_load_explicit(&q->spinLimit, memory_order_relaxed);
+    if (limit == 0) {
+        return 0;
+    }
+    for (int i = 0; i < limit; i++) {
+        int count = atomic_load_explicit(&q->count, memory_order_relaxed);
+        if (wantElement ? count > 0 : count < q->capacity) {
+            atomic_store_explicit(&q->spinLimit, limit < MAX_SPIN ? limit * 2 : MAX_SPIN,
+                                  memory_order_relaxed);
+            return 1;
+        }
+        cpuRelax();
+    }
+    atomic_store_explicit(&q->spinLimit, limit > MIN_SPIN ? limit / 2 : MIN_SPIN, memory_order_relaxed);
+    return 0;
+}
+
+/*
+ * sleepOn: Sleeps on cond until it is signalled or the deadline passes (deadline < 0: no deadline).
+ * Must be called with the mutex held. Returns 1 if the deadline passed.
+ */
+static int sleepOn(BlockingQueue* q, pthread_cond_t* cond, long long deadline) {
+    q->stats.sleeps++;
+    if (deadline < 0) {
+        pthread_cond_wait(cond, &q->mutex);
+        return 0;
+    }
+    struct timespec ts = { deadline / 1000000000LL, deadline % 1000000000LL };
+    return pthread_cond_timedwait(cond, &q->mutex, &ts) == ETIMEDOUT;
+}
+
+/*
+ * recordWait: Adds one completed operation that first slept at sleepStart to the latency counters.
+ */
+static void recordWait(BlockingQueue* q, long long sleepStart) {
+    if (sleepStart == 0) {
+        return;
+    }
+    long long waited = nowNs() - sleepStart;
+    q->stats.waitedOperations++;
+    q->stats.totalWaitNs += waited;
+    if (waited > q->stats.maxWaitNs) {
+        q->stats.maxWaitNs = waited;
+    }
+}
+
+/*
+ * enqueueTimeout: Adds value to the rear of the queue, waiting while the queue is full.
+ * timeoutNs < 0 waits as long as needed, 0 does not wait at all.
+ * Returns QUEUE_OK, QUEUE_TIMEOUT if the queue stayed full, or QUEUE_CLOSED if it was closed.
+ * Explanation: A full queue pushes back on the producer, so the queue never holds more than
+ * capacity elements. A sleeping consumer is signalled once the element is in.
+ */
+QueueStatus enqueueTimeout(BlockingQueue* q, int value, long long timeoutNs) {
+    int spun = timeoutNs != 0 && atomic_load_explicit(&q->count, memory_order_relaxed) >= q->capacity
+               && spinUntil(q, 0);
+    long long deadline = timeoutNs > 0 ? nowNs() + timeoutNs : -1;
+    long long sleepStart = 0;
+    pthread_mutex_lock(&q->mutex);
+    q->stats.spinHits += spun;
+    while (size(q->queue) >= q->capacity && !q->closed) {
+        if (timeoutNs == 0) {
+            pthread_mutex_unlock(&q->mutex);
+            return QUEUE_TIMEOUT;
+        }
+        if (sleepStart == 0) {
+            sleepStart = nowNs();
+        } else {
+            q->stats.spuriousWakeups++;
+        }
+        q->sleepingProducers++;
+        int timedOut = sleepOn(q, &q->notFull, deadline);
+        q->sleepingProducers--;
+        if (timedOut && size(q->queue) >= q->capacity && !q->closed) {
+            q->stats.timeouts++;
+            pthread_mutex_unlock(&q->mutex);
+            return QUEUE_TIMEOUT;
+        }
+    }
+    if (q->closed) {
+        pthread_mutex_unlock(&q->mutex);
+        return QUEUE_CLOSED;
+    }
+    enqueue(q->queue, value);
+    atomic_store_explicit(&q->count, size(q->queue), memory_order_relaxed);
+    if (q->sleepingConsumers > 0 && size(q->queue) <= q->sleepingConsumers) {
+        q->stats.wakeups++;
+        pthread_cond_signal(&q->notEmpty);
+    }
+    recordWait(q, sleepStart);
+    pthread_mutex_unlock(&q->mutex);
+    return QUEUE_OK;
+}
+
+/*
+ * dequeueTimeout: Removes the front element into *value, waiting while the queue is empty.
+ * timeoutNs < 0 waits as long as needed, 0 does not wait at all.
+ * Returns QUEUE_OK, QUEUE_TIMEOUT if no element arrived in time, or QUEUE_CLOSED if the queue
+ * was closed and every element has been taken.
+ */
+QueueStatus dequeueTimeout(BlockingQueue* q, int* value, long long timeoutNs) {
+    int spun = timeoutNs != 0 && atomic_load_explicit(&q->count, memory_order_relaxed) == 0
+               && spinUntil(q, 1);
+    long long deadline = timeoutNs > 0 ? nowNs() + timeoutNs : -1;
+    long long sleepStart = 0;
+    pthread_mutex_lock(&q->mutex);
+    q->stats.spinHits += spun;
+    while (isEmpty(q->queue) && !q->closed) {
+        if (timeoutNs == 0) {
+            pthread_mutex_unlock(&q->mutex);
+            return QUEUE_TIMEOUT;
+        }
+        if (sleepStart == 0) {
+            sleepStart = nowNs();
+        } else {
+            q->stats.spuriousWakeups++;
+        }
+        q->sleepingConsumers++;
+        int timedOut = sleepOn(q, &q->notEmpty, deadline);
+        q->sleepingConsumers--;
+        if (timedOut && isEmpty(q->queue) && !q->closed) {
+            q->stats.timeouts++;
+            pthread_mutex_unlock(&q->mutex);
+            return QUEUE_TIMEOUT;
+        }
+    }
+    if (isEmpty(q->queue)) {
+        pthread_mutex_unlock(&q->mutex);
+        return QUEUE_CLOSED;    // Closed and drained.
+    }
+    *value = dequeue(q->queue);
+    atomic_store_explicit(&q->count, size(q->queue), memory_order_relaxed);
+    if (q->sleepingProducers > 0 && q->capacity - size(q->queue) <= q->sleepingProducers) {
+        q->stats.wakeups++;
+        pthread_cond_signal(&q->notFull);
+    }
+    recordWait(q, sleepStart);
+    pthread_mutex_unlock(&q->mutex);
+    return QUEUE_OK;
+}
+
+/*
+ * enqueueWait / dequeueWait / tryDequeue: The common cases of the two functions above.
+ */
+QueueStatus enqueueWait(BlockingQueue* q, int value) {
+    return enqueueTimeout(q, value, -1);
+}
+
+QueueStatus dequeueWait(BlockingQueue* q, int* value) {
+    return dequeueTimeout(q, value, -1);
+}
+
+QueueStatus tryDequeue(BlockingQueue* q, int* value) {
+    return dequeueTimeout(q, value, 0);
+}
+
+/*
+ * closeQueue: Shuts the queue down.
+ * Explanation: Every later enqueue returns QUEUE_CLOSED. Dequeues keep returning the elements that
+ * are left and return QUEUE_CLOSED once the queue is empty, so consumers can simply loop until
+ * they see QUEUE_CLOSED. All sleeping threads are woken to see the change.
+ */
+void closeQueue(BlockingQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    q->closed = 1;
+    pthread_cond_broadcast(&q->notEmpty);
+    pthread_cond_broadcast(&q->notFull);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+/*
+ * printStats: Prints the counters of q.
+ */
+void printStats(BlockingQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    QueueStats s = q->stats;
+    pthread_mutex_unlock(&q->mutex);
+    printf("    sleeps %lld, wake-ups %lld, spurious %lld, spin hits %lld, timeouts %lld\n",
+           s.sleeps, s.wakeups, s.spuriousWakeups, s.spinHits, s.timeouts);
+    if (s.waitedOperations > 0) {
+        printf("    %lld operations slept, waiting %.1f us on average, %.1f us at most\n",
+               s.waitedOperations, s.totalWaitNs / 1e3 / s.waitedOperations, s.maxWaitNs / 1e3);
+    }
+}
+
+// Arguments of a demo thread.
+typedef struct {
+    BlockingQueue* queue;
+    int count;                  // Producer: elements to enqueue.
+    int burst;                  // Producer: elements per burst.
+    long long pauseNs;          // Producer: pause between bursts.
+    long long* sentAt;          // Producer: time each element was enqueued, indexed by value.
+    int polling;                // Consumer: poll with tryDequeue instead of blocking.
+    long long received;         // Consumer: elements taken.
+    long long sum;              // Consumer: sum of the elements taken.
+    long long totalLatencyNs;   // Consumer: time from enqueue to dequeue, summed.
+    long long maxLatencyNs;
+    double cpuSeconds;          // Consumer: CPU time the thread used.
+} DemoArgs;
+
+static void sleepFor(long long ns) {
+    struct timespec ts = { ns / 1000000000LL, ns % 1000000000LL };
+    nanosleep(&ts, NULL);
+}
+
+void* producerThread(void* arg) {
+    DemoArgs* a = (DemoArgs*)arg;
+    for (int i = 0; i < a->count; i++) {
+        if (a->burst > 0 && i > 0 && i % a->burst == 0) {
+            sleepFor(a->pauseNs);
+        }
+        if (a->sentAt != NULL) {
+            a->sentAt[i] = nowNs();
+        }
+        if (enqueueWait(a->queue, i) != QUEUE_OK) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * consumerThread: Takes elements until the queue is closed and drained.
+ * A polling consumer calls tryDequeue in a loop, the way the 07 queue has to be used.
+ */
+void* consumerThread(void* arg) {
+    DemoArgs* a = (DemoArgs*)arg;
+    int value;
+    for (;;) {
+        QueueStatus status = a->polling ? tryDequeue(a->queue, &value) : dequeueWait(a->queue, &value);
+        if (status == QUEUE_CLOSED) {
+            break;
+        }
+        if (status != QUEUE_OK) {
+            continue;
+        }
+        if (a->sentAt != NULL) {
+            long long latency = nowNs() - a->sentAt[value];
+            a->totalLatencyNs += latency;
+            if (latency > a->maxLatencyNs) {
+                a->maxLatencyNs = latency;
+            }
+        }
+        a->received++;
+        a->sum += value;
+    }
+    struct timespec cpu;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    a->cpuSeconds = cpu.tv_sec + cpu.tv_nsec / 1e9;
+    return NULL;
+}
+
+/*
+ * drainDemo: Several consumers block on an empty queue; one producer fills it through a small
+ * queue (back-pressure) and closes it. Every element must be taken exactly once.
+ */
+void drainDemo(int consumers, int count, int capacity) {
+    BlockingQueue q;
+    initBlockingQueue(&q, capacity);
+    DemoArgs producer = { &q, count, 0, 0, NULL, 0, 0, 0, 0, 0, 0 };
+    DemoArgs args[8];
+    pthread_t handles[8], producerHandle;
+    for (int c = 0; c < consumers; c++) {
+        DemoArgs a = { &q, 0, 0, 0, NULL, 0, 0, 0, 0, 0, 0 };
+        args[c] = a;
+        pthread_create(&handles[c], NULL, consumerThread, &args[c]);
+    }
+    pthread_create(&producerHandle, NULL, producerThread, &producer);
+    pthread_join(producerHandle, NULL);
+    closeQueue(&q);
+    long long received = 0, sum = 0;
+    for (int c = 0; c < consumers; c++) {
+        pthread_join(handles[c], NULL);
+        received += args[c].received;
+        sum += args[c].sum;
+    }
+    printf("%d consumers, %d elements through a queue of capacity %d, then close:\n",
+           consumers, count, capacity);
+    printf("    received %lld elements, %s\n", received,
+           received == count && sum == (long long)count * (count - 1) / 2 ? "all exactly once" : "LOST ELEMENTS");
+    printf("    enqueue after close: %s\n", enqueueWait(&q, 1) == QUEUE_CLOSED ? "closed" : "accepted");
+    printStats(&q);
+    destroyBlockingQueue(&q);
+}
+
+/*
+ * idleDemo: A producer sends bursts with pauses in between, as a request handler would; one
+ * consumer polls and one blocks. Compares the CPU time the consumer burns while idle and the
+ * time from enqueue to dequeue.
+ */
+void idleDemo(int bursts, int burst, long long pauseNs) {
+    int count = bursts * burst;
+    long long* sentAt = (long long*)malloc((size_t)count * sizeof(long long));
+    if (sentAt == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    printf("\n%d bursts of %d elements, %.1f ms apart:\n", bursts, burst, pauseNs / 1e6);
+    printf("consumer   CPU time (ms)   latency avg (us)   latency max (us)\n");
+    for (int polling = 1; polling >= 0; polling--) {
+        BlockingQueue q;
+        initBlockingQueue(&q, 1024);
+        DemoArgs producer = { &q, count, burst, pauseNs, sentAt, 0, 0, 0, 0, 0, 0 };
+        DemoArgs consumer = { &q, 0, 0, 0, sentAt, polling, 0, 0, 0, 0, 0 };
+        pthread_t producerHandle, consumerHandle;
+        pthread_create(&consumerHandle, NULL, consumerThread, &consumer);
+        pthread_create(&producerHandle, NULL, producerThread, &producer);
+        pthread_join(producerHandle, NULL);
+        closeQueue(&q);
+        pthread_join(consumerHandle, NULL);
+        printf("%-8s   %13.1f   %16.1f   %16.1f%s\n", polling ? "polling" : "blocking",
+               consumer.cpuSeconds * 1e3, consumer.totalLatencyNs / 1e3 / count,
+               consumer.maxLatencyNs / 1e3, consumer.received == count ? "" : "   LOST ELEMENTS");
+        if (!polling) {
+            printStats(&q);
+        }
+        destroyBlockingQueue(&q);
+    }
+    free(sentAt);
+}
+
+// Main function to demonstrate timeouts, back-pressure, close/drain and idle consumers.
+int main(int argc, char* argv[]) {
+    int bursts = argc > 1 ? atoi(argv[1]) : 50;
+    if (bursts <= 0) {
+        printf("Usage: %s [bursts]\n", argv[0]);
+        return 1;
+    }
+
+    BlockingQueue q;
+    initBlockingQueue(&q, 2);
+    int value;
+    long long start = nowNs();
+    QueueStatus status = dequeueTimeout(&q, &value, 20000000);
+    printf("Dequeue from the empty queue with a 20 ms timeout: %s after %.1f ms\n",
+           status == QUEUE_TIMEOUT ? "timed out" : "returned", (nowNs() - start) / 1e6);
+    enqueueWait(&q, 10);
+    enqueueWait(&q, 20);
+    status = enqueueTimeout(&q, 30, 5000000);
+    printf("Enqueue into the full queue (capacity 2) with a 5 ms timeout: %s\n",
+           status == QUEUE_TIMEOUT ? "timed out" : "accepted");
+    closeQueue(&q);
+    printf("After close:");
+    while (dequeueWait(&q, &value) == QUEUE_OK) {
+        printf(" %d", value);
+    }
+    printf(", then closed\n");
+    destroyBlockingQueue(&q);
+    printf("\n");
+
+    drainDemo(4, 200000, 64);
+    idleDemo(bursts, 100, 2000000);
+    return 0;
+}
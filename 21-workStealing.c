@@ -0,0 +1,624 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/*
+ * 21-workStealing.c: A work-stealing deque (Chase and Lev) and a small fork/join scheduler built
+ * on it, used to run the tree traversal of 08 and the DFS of 09 on several threads.
+ * Explanation: Every worker thread owns one deque of tasks. The owner pushes and pops at the
+ * bottom, like a stack, so the task it just spawned runs next while its data is still in cache.
+ * An idle worker steals from the top of another worker's deque, where the oldest and usually
+ * largest tasks are. The owner and the thieves work at opposite ends, so the only contention is
+ * for the last task, which is settled with one CAS on top; there is no shared task queue.
+ * The deque is a circular array that grows when it is full. An old array is not freed at once,
+ * because a thief may still be reading from it; it is kept until the deque is destroyed.
+ * spawn pushes a task on the current worker's deque; join waits for a spawned task, running
+ * other tasks meanwhile: first the worker's own (usually the awaited task itself), then stolen
+ * ones once its own deque is empty.
+ * The benchmark compares the parallel tree sum and DFS with the sequential versions for 1, 2,
+ * 4, ... maxWorkers workers.
+ * Usage: ./workStealing [maxWorkers]
+ */
+
+#define CACHE_LINE 64           // Bytes per cache line.
+#define MAX_WORKERS 64          // Upper bound on workers.
+#define DEQUE_INITIAL_SIZE 64   // Starting capacity of a deque, a power of two.
+
+typedef struct Worker Worker;
+
+// A unit of work. Tasks embed this as their first member.
+typedef struct Task {
+    void (*run)(Worker* w, struct Task* task);  // Does the work.
+    atomic_int done;                            // Set once run has returned.
+} Task;
+
+// Circular array of a deque. Elements are atomic because a thief may read a slot the owner writes.
+typedef struct TaskArray {
+    long size;                  // Number of slots, a power of two.
+    struct TaskArray* previous; // Smaller array this one replaced, freed with the deque.
+    _Atomic(Task*) slots[];
+} TaskArray;
+
+/*
+ * Deque: top and bottom only grow (the slot of index i is i & (size - 1)) and are never reset,
+ * so a thief that read top can tell with a CAS whether somebody took that task in the meantime.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_long top;       // Next index to steal; advanced by thieves and the owner.
+    _Alignas(CACHE_LINE) atomic_long bottom;    // Next index to push; changed only by the owner.
+    _Atomic(TaskArray*) array;
+} Deque;
+
+static TaskArray* newArray(long size, TaskArray* previous) {
+    TaskArray* a = (TaskArray*)malloc(sizeof(TaskArray) + (size_t)size * sizeof(_Atomic(Task*)));
+    if (a == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    a->size = size;
+    a->previous = previous;
+    return a;
+}
+
+void initDeque(Deque* d) {
+    atomic_init(&d->top, 0);
+    atomic_init(&d->bottom, 0);
+    atomic_init(&d->array, newArray(DEQUE_INITIAL_SIZE, NULL));
+}
+
+void destroyDeque(Deque* d) {
+    TaskArray* a = atomic_load(&d->array);
+    while (a != NULL) {
+        TaskArray* previous = a->previous;
+        free(a);
+        a = previous;
+    }
+}
+
+/*
+ * growDeque: Owner only. Copies the tasks from top to bottom into an array twice as large.
+ * Explanation: The indices stay the same, only their slots move, so thieves that already read top
+ * are not affected; the release store publishes the copied slots before the new array.
+ */
+static TaskArray* growDeque(Deque* d, TaskArray* a, long top, long bottom) {
+    TaskArray* grown = newArray(a->size * 2, a);
+    for (long i = top; i < bottom; i++) {
+        Task* task = atomic_load_explicit(&a->slots[i & (a->size - 1)], memory_order_relaxed);
+        atomic_store_explicit(&grown->slots[i & (grown->size - 1)], task, memory_order_relaxed);
+    }
+    atomic_store_explicit(&d->array, grown, memory_order_release);
+    return grown;
+}
+
+/*
+ * pushBottom: Owner only. Adds a task at the bottom.
+ */
+void pushBottom(Deque* d, Task* task) {
+    long bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&d->top, memory_order_acquire);
+    TaskArray* a = atomic_load_explicit(&d->array, memory_order_relaxed);
+    if (bottom - top >= a->size) {
+        a = growDeque(d, a, top, bottom);
+    }
+    atomic_store_explicit(&a->slots[bottom & (a->size - 1)], task, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, bottom + 1, memory_order_release);   // The task before the new bottom.
+}
+
+/*
+ * popBottom: Owner only. Takes the task at the bottom, the one pushed last, or returns NULL.
+ * Explanation: The owner first claims the slot by lowering bottom; the fence makes that visible
+ * before it reads top. If more than one task is left, no thief can reach the claimed one. If it is
+ * the last task, a thief may be after it too, and the CAS on top decides who gets it.
+ */
+Task* popBottom(Deque* d) {
+    long bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    TaskArray* a = atomic_load_explicit(&d->array, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&d->top, memory_order_relaxed);
+    if (top > bottom) {
+        atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);   // Was empty.
+        return NULL;
+    }
+    Task* task = atomic_load_explicit(&a->slots[bottom & (a->size - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        // The last task: race the thieves for it.
+        if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+/*
+ * stealTop: Any thread. Takes the task at the top, the oldest one, or returns NULL if the deque is
+ * empty or another thread took that task first.
+ */
+Task* stealTop(Deque* d) {
+    long top = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (top >= bottom) {
+        return NULL;
+    }
+    TaskArray* a = atomic_load_explicit(&d->array, memory_order_acquire);
+    Task* task = atomic_load_explicit(&a->slots[top & (a->size - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+// Scheduler state shared by the workers.
+typedef struct Scheduler Scheduler;
+
+struct Worker {
+    Deque deque;                // Tasks spawned by this worker.
+    Scheduler* scheduler;
+    int id;
+    unsigned int random;        // State for choosing victims.
+    long long executed;         // Tasks run.
+    long long steals;           // Tasks stolen from other workers.
+    pthread_t thread;
+};
+
+struct Scheduler {
+    int workers;
+    atomic_int stop;            // Set to end the helper threads.
+    Worker worker[MAX_WORKERS];
+};
+
+/*
+ * runTask: Runs a task on worker w and marks it done. The release store publishes the task's
+ * results to the thread that joins it.
+ */
+static void runTask(Worker* w, Task* task) {
+    task->run(w, task);
+    w->executed++;
+    atomic_store_explicit(&task->done, 1, memory_order_release);
+}
+
+/*
+ * trySteal: Tries every other worker once, starting at a random one. Returns a stolen task or NULL.
+ */
+static Task* trySteal(Worker* w) {
+    Scheduler* s = w->scheduler;
+    w->random = w->random * 1103515245u + 12345u;
+    int start = (int)((w->random >> 16) % (unsigned int)s->workers);
+    for (int i = 0; i < s->workers; i++) {
+        Worker* victim = &s->worker[(start + i) % s->workers];
+        if (victim == w) {
+            continue;
+        }
+        Task* task = stealTop(&victim->deque);
+        if (task != NULL) {
+            w->steals++;
+            return task;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * idle: Called after a round of failed steals. Spins briefly, then yields the CPU, then sleeps,
+ * so helper threads cost nothing while there is no parallel work.
+ */
+static void idle(int* misses) {
+    (*misses)++;
+    if (*misses < 16) {
+        return;
+    } else if (*misses < 64) {
+        sched_yield();
+    } else {
+        struct timespec ts = { 0, 50000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+/*
+ * spawn: Makes task available to run, on this worker or a thief.
+ */
+void spawn(Worker* w, Task* task) {
+    atomic_init(&task->done, 0);
+    pushBottom(&w->deque, task);
+}
+
+/*
+ * join: Waits until a task spawned by this worker is done.
+ * Explanation: Tasks spawned after it are popped and run first; if the awaited task was not
+ * stolen, it comes next, so a join without thieves just runs the task in place. If it was stolen,
+ * the worker helps by stealing other work until the thief is done.
+ */
+void join(Worker* w, Task* task) {
+    int misses = 0;
+    while (!atomic_load_explicit(&task->done, memory_order_acquire)) {
+        Task* next = popBottom(&w->deque);
+        if (next == NULL) {
+            next = trySteal(w);
+        }
+        if (next != NULL) {
+            runTask(w, next);
+            misses = 0;
+        } else {
+            idle(&misses);
+        }
+    }
+}
+
+// Helper thread: steals and runs tasks until the scheduler stops.
+static void* workerLoop(void* arg) {
+    Worker* w = (Worker*)arg;
+    int misses = 0;
+    while (!atomic_load_explicit(&w->scheduler->stop, memory_order_relaxed)) {
+        Task* task = trySteal(w);
+        if (task != NULL) {
+            runTask(w, task);
+            misses = 0;
+        } else {
+            idle(&misses);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * createScheduler / destroyScheduler: Start workers - 1 helper threads (the calling thread is
+ * worker 0) and stop them again.
+ */
+Scheduler* createScheduler(int workers) {
+    Scheduler* s = (Scheduler*)calloc(1, sizeof(Scheduler));
+    if (s == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    s->workers = workers;
+    atomic_init(&s->stop, 0);
+    for (int i = 0; i < workers; i++) {
+        initDeque(&s->worker[i].deque);
+        s->worker[i].scheduler = s;
+        s->worker[i].id = i;
+        s->worker[i].random = 2654435761u * (unsigned int)(i + 1);
+    }
+    for (int i = 1; i < workers; i++) {
+        pthread_create(&s->worker[i].thread, NULL, workerLoop, &s->worker[i]);
+    }
+    return s;
+}
+
+void destroyScheduler(Scheduler* s) {
+    atomic_store(&s->stop, 1);
+    for (int i = 1; i < s->workers; i++) {
+        pthread_join(s->worker[i].thread, NULL);
+    }
+    for (int i = 0; i < s->workers; i++) {
+        destroyDeque(&s->worker[i].deque);
+    }
+    free(s);
+}
+
+/*
+ * runRoot: Runs task on the calling thread as worker 0 and returns once it and everything it
+ * spawned is done.
+ */
+void runRoot(Scheduler* s, Task* task) {
+    atomic_init(&task->done, 0);
+    runTask(&s->worker[0], task);
+}
+
+/*
+ * resetCounters / totalSteals: Statistics over all workers.
+ */
+void resetCounters(Scheduler* s) {
+    for (int i = 0; i < s->workers; i++) {
+        s->worker[i].executed = 0;
+        s->worker[i].steals = 0;
+    }
+}
+
+long long totalSteals(Scheduler* s) {
+    long long steals = 0;
+    for (int i = 0; i < s->workers; i++) {
+        steals += s->worker[i].steals;
+    }
+    return steals;
+}
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * The binary search tree of 08.
+ */
+typedef struct Node {
+    int data;
+    struct Node* left;
+    struct Node* right;
+} Node;
+
+Node* createNode(int data) {
+    Node* newNode = (Node*)malloc(sizeof(Node));
+    if (newNode == NULL) {
+        printf("Memory allocation error\n");
+        exit(1);
+    }
+    newNode->data = data;
+    newNode->left = newNode->right = NULL;
+    return newNode;
+}
+
+/*
+ * insert: Inserts data like insert in 08, with a loop instead of recursion.
+ */
+Node* insert(Node* root, int data) {
+    Node** link = &root;
+    while (*link != NULL && (*link)->data != data) {
+        link = data < (*link)->data ? &(*link)->left : &(*link)->right;
+    }
+    if (*link == NULL) {
+        *link = createNode(data);
+    }
+    return root;
+}
+
+void freeTree(Node* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+long long treeSum(Node* root) {
+    return root == NULL ? 0 : root->data + treeSum(root->left) + treeSum(root->right);
+}
+
+#define TREE_CUTOFF 12          // Below this depth, subtrees are summed without spawning.
+
+// Task: sum of the subtree at root.
+typedef struct {
+    Task task;
+    Node* root;
+    int depth;
+    long long sum;
+} SumTask;
+
+/*
+ * sumTask: Spawns the left subtree, sums the right one itself and then waits for the left one.
+ * Deep subtrees are summed sequentially, where a task would cost more than the work it saves.
+ */
+static void sumTask(Worker* w, Task* task) {
+    SumTask* t = (SumTask*)task;
+    if (t->root == NULL || t->depth >= TREE_CUTOFF) {
+        t->sum = treeSum(t->root);
+        return;
+    }
+    SumTask left = { { sumTask, 0 }, t->root->left, t->depth + 1, 0 };
+    SumTask right = { { sumTask, 0 }, t->root->right, t->depth + 1, 0 };
+    spawn(w, &left.task);
+    sumTask(w, &right.task);
+    join(w, &left.task);
+    t->sum = t->root->data + left.sum + right.sum;
+}
+
+long long parallelTreeSum(Scheduler* s, Node* root) {
+    SumTask t = { { sumTask, 0 }, root, 0, 0 };
+    runRoot(s, &t.task);
+    return t.sum;
+}
+
+/*
+ * The adjacency matrix graph of 09.
+ */
+typedef struct {
+    int numVertices;
+    int** adjMatrix;
+} Graph;
+
+Graph* createGraph(int vertices) {
+    Graph* graph = (Graph*)malloc(sizeof(Graph));
+    int** rows = (int**)malloc(vertices * sizeof(int*));
+    if (graph == NULL || rows == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    graph->numVertices = vertices;
+    graph->adjMatrix = rows;
+    for (int i = 0; i < vertices; i++) {
+        rows[i] = (int*)calloc(vertices, sizeof(int));
+        if (rows[i] == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    return graph;
+}
+
+void addEdge(Graph* graph, int src, int dest) {
+    graph->adjMatrix[src][dest] = 1;
+    graph->adjMatrix[dest][src] = 1;
+}
+
+void freeGraph(Graph* graph) {
+    for (int i = 0; i < graph->numVertices; i++) {
+        free(graph->adjMatrix[i]);
+    }
+    free(graph->adjMatrix);
+    free(graph);
+}
+
+/*
+ * DFSUtil: The DFS of 09 without the printing. Counts the vertices reached from vertex.
+ */
+int DFSUtil(Graph* graph, int vertex, char* visited) {
+    int reached = 1;
+    visited[vertex] = 1;
+    for (int i = 0; i < graph->numVertices; i++) {
+        if (graph->adjMatrix[vertex][i] == 1 && !visited[i]) {
+            reached += DFSUtil(graph, i, visited);
+        }
+    }
+    return reached;
+}
+
+// Task: visit vertex and everything reachable from it that no other task has claimed.
+typedef struct {
+    Task task;
+    Graph* graph;
+    atomic_char* visited;
+    int vertex;
+    int reached;                // Vertices this task and its children visited.
+} DfsTask;
+
+/*
+ * dfsTask: Claims the unvisited neighbours of vertex, spawns a task for each but the last and
+ * continues with the last one itself.
+ * Explanation: A vertex is claimed with an atomic exchange on its visited flag, so each vertex is
+ * visited exactly once even when several tasks reach it at the same time. The visiting order
+ * differs from the sequential DFS, but the set of reached vertices is the same.
+ */
+static void dfsTask(Worker* w, Task* task) {
+    DfsTask* t = (DfsTask*)task;
+    Graph* graph = t->graph;
+    int* row = graph->adjMatrix[t->vertex];
+    int claimed = 0, capacity = 0;
+    DfsTask* children = NULL;
+    for (int i = 0; i < graph->numVertices; i++) {
+        if (row[i] == 1 && !atomic_load_explicit(&t->visited[i], memory_order_relaxed)
+            && !atomic_exchange_explicit(&t->visited[i], 1, memory_order_relaxed)) {
+            if (claimed == capacity) {
+                capacity = capacity == 0 ? 8 : capacity * 2;
+                children = (DfsTask*)realloc(children, capacity * sizeof(DfsTask));
+                if (children == NULL) {
+                    printf("Memory allocation failed.\n");
+                    exit(1);
+                }
+            }
+            DfsTask child = { { dfsTask, 0 }, graph, t->visited, i, 0 };
+            children[claimed++] = child;
+        }
+    }
+    // children no longer moves: spawn all but the last child, run the last one here.
+    for (int c = 0; c < claimed - 1; c++) {
+        spawn(w, &children[c].task);
+    }
+    t->reached = 1;
+    if (claimed > 0) {
+        dfsTask(w, &children[claimed - 1].task);
+        t->reached += children[claimed - 1].reached;
+    }
+    for (int c = claimed - 2; c >= 0; c--) {
+        join(w, &children[c].task);
+        t->reached += children[c].reached;
+    }
+    free(children);
+}
+
+int parallelDFS(Scheduler* s, Graph* graph, int startVertex, atomic_char* visited) {
+    for (int i = 0; i < graph->numVertices; i++) {
+        atomic_init(&visited[i], 0);
+    }
+    atomic_store(&visited[startVertex], 1);
+    DfsTask t = { { dfsTask, 0 }, graph, visited, startVertex, 0 };
+    runRoot(s, &t.task);
+    return t.reached;
+}
+
+/*
+ * benchmark: Runs the sequential tree sum and DFS once, then the parallel versions with 1, 2, 4,
+ * ... maxWorkers workers, and checks that every run finds the same result.
+ */
+void benchmark(int maxWorkers, int treeSize, int vertices, int degree) {
+    srand(42);
+    Node* root = NULL;
+    for (int i = 0; i < treeSize; i++) {
+        root = insert(root, rand() % (treeSize * 4));
+    }
+    Graph* graph = createGraph(vertices);
+    for (int v = 0; v < vertices; v++) {
+        for (int e = 0; e < degree / 2; e++) {
+            addEdge(graph, v, rand() % vertices);
+        }
+    }
+    char* visited = (char*)calloc(vertices, 1);
+    atomic_char* shared = (atomic_char*)malloc(vertices * sizeof(atomic_char));
+    if (visited == NULL || shared == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    double start = nowSeconds();
+    long long sum = treeSum(root);
+    double sumTime = nowSeconds() - start;
+    start = nowSeconds();
+    int reached = DFSUtil(graph, 0, visited);
+    double dfsTime = nowSeconds() - start;
+
+    printf("Tree of %d random keys; graph of %d vertices with about %d edges each\n",
+           treeSize, vertices, degree);
+    printf("workers   tree sum (ms)  speedup   steals   DFS (ms)  speedup   steals\n");
+    printf("%-7s   %13.2f  %7s   %6s   %8.2f  %7s   %6s\n", "seq", sumTime * 1e3, "", "",
+           dfsTime * 1e3, "", "");
+    for (int workers = 1; workers <= maxWorkers; workers *= 2) {
+        Scheduler* s = createScheduler(workers);
+        start = nowSeconds();
+        long long parallelSum = parallelTreeSum(s, root);
+        double parallelSumTime = nowSeconds() - start;
+        long long sumSteals = totalSteals(s);
+        resetCounters(s);
+        start = nowSeconds();
+        int parallelReached = parallelDFS(s, graph, 0, shared);
+        double parallelDfsTime = nowSeconds() - start;
+        printf("%7d   %13.2f  %6.2fx   %6lld   %8.2f  %6.2fx   %6lld%s\n", workers,
+               parallelSumTime * 1e3, sumTime / parallelSumTime, sumSteals,
+               parallelDfsTime * 1e3, dfsTime / parallelDfsTime, totalSteals(s),
+               parallelSum == sum && parallelReached == reached ? "" : "   RESULTS DIFFER");
+        destroyScheduler(s);
+        if (workers < maxWorkers && workers * 2 > maxWorkers) {
+            workers = maxWorkers / 2;   // Always finish with maxWorkers itself.
+        }
+    }
+    free(visited);
+    free(shared);
+    freeGraph(graph);
+    freeTree(root);
+}
+
+// Main function to demonstrate the deque and run the scaling benchmark.
+int main(int argc, char* argv[]) {
+    int maxWorkers = argc > 1 ? atoi(argv[1]) : 8;
+    if (maxWorkers < 1 || maxWorkers > MAX_WORKERS) {
+        printf("Usage: %s [maxWorkers (1..%d)]\n", argv[0], MAX_WORKERS);
+        return 1;
+    }
+
+    // Single-threaded walk-through: the owner pops the newest task, a thief steals the oldest.
+    Deque d;
+    initDeque(&d);
+    Task tasks[100];
+    for (int i = 0; i < 100; i++) {
+        pushBottom(&d, &tasks[i]);
+    }
+    TaskArray* a = atomic_load(&d.array);
+    printf("Pushed 100 tasks, the deque grew to %ld slots\n", a->size);
+    printf("popBottom returns task %d, stealTop returns task %d\n",
+           (int)(popBottom(&d) - tasks), (int)(stealTop(&d) - tasks));
+    int left = 0;
+    while (popBottom(&d) != NULL) {
+        left++;
+    }
+    printf("%d tasks left, then the deque is empty: %s\n\n", left, popBottom(&d) == NULL ? "yes" : "no");
+    destroyDeque(&d);
+
+    benchmark(maxWorkers, 1 << 20, 4000, 16);
+    return 0;
+}
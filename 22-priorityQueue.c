@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include "priorityHeap.h"
+
+/*
+ * 22-priorityQueue.c: Binary and 4-ary heap priority queues from priorityHeap.h, with Dijkstra's
+ * shortest paths on the adjacency matrix graph of 09.
+ * Explanation: The queue of 07 hands elements out in arrival order; a priority queue hands out the
+ * element with the smallest key first. Both heaps are generated from the same code, only the
+ * number of children per node differs. A 4-ary heap is half as deep, so a push moves an element
+ * up half as many levels; a pop compares 4 children per level instead of 2, but those 4 share one
+ * cache line, which matters once the heap no longer fits in the cache.
+ * The benchmark compares both heaps on random pushes and pops, on O(n) heapify followed by pops,
+ * on decrease-key, and on Dijkstra's algorithm, where every relaxed edge is one decrease-key.
+ * Usage: ./priorityQueue [elements]
+ */
+
+DEFINE_HEAP(BinaryHeap, Binary, 2)
+DEFINE_HEAP(QuadHeap, Quad, 4)
+
+#define NO_PATH INT_MAX     // Distance of a vertex that cannot be reached.
+
+/*
+ * The graph of 09, with the matrix entry used as the edge weight (0: no edge).
+ * addEdge of 09 stores 1, so on an 09 graph the distances are the numbers of edges.
+ */
+typedef struct {
+    int numVertices;
+    int** adjMatrix;
+} Graph;
+
+Graph* createGraph(int vertices) {
+    Graph* graph = (Graph*)malloc(sizeof(Graph));
+    int** rows = (int**)malloc(vertices * sizeof(int*));
+    if (graph == NULL || rows == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    graph->numVertices = vertices;
+    graph->adjMatrix = rows;
+    for (int i = 0; i < vertices; i++) {
+        rows[i] = (int*)calloc(vertices, sizeof(int));
+        if (rows[i] == NULL) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    return graph;
+}
+
+/*
+ * addWeightedEdge: Adds an undirected edge of the given weight (at least 1).
+ */
+void addWeightedEdge(Graph* graph, int src, int dest, int weight) {
+    graph->adjMatrix[src][dest] = weight;
+    graph->adjMatrix[dest][src] = weight;
+}
+
+void freeGraph(Graph* graph) {
+    for (int i = 0; i < graph->numVertices; i++) {
+        free(graph->adjMatrix[i]);
+    }
+    free(graph->adjMatrix);
+    free(graph);
+}
+
+/*
+ * DEFINE_DIJKSTRA: dijkstraX(graph, start, dist) stores the length of the shortest path from start
+ * to every vertex in dist (NO_PATH if there is none) and returns the number of decrease-keys.
+ * Explanation: The heap holds the vertices whose distance is known to be an upper bound. The
+ * vertex with the smallest bound is final when it is popped; every edge out of it may lower the
+ * bound of a neighbour, which decreaseKey applies in place instead of pushing a second copy.
+ */
+#define DEFINE_DIJKSTRA(Name, Suffix)                                                           \
+long long dijkstra##Suffix(Graph* graph, int start, int* dist) {                                \
+    int n = graph->numVertices;                                                                 \
+    long long updates = 0;                                                                      \
+    Name heap;                                                                                  \
+    init##Name(&heap, n);                                                                       \
+    for (int v = 0; v < n; v++) {                                                               \
+        dist[v] = NO_PATH;                                                                      \
+    }                                                                                           \
+    dist[start] = 0;                                                                            \
+    push##Suffix(&heap, start, 0);                                                              \
+    while (!isEmpty##Suffix(&heap)) {                                                           \
+        int d;                                                                                  \
+        int u = pop##Suffix(&heap, &d);                                                         \
+        int* row = graph->adjMatrix[u];                                                         \
+        for (int v = 0; v < n; v++) {                                                           \
+            if (row[v] > 0 && d + row[v] < dist[v]) {                                           \
+                dist[v] = d + row[v];                                                           \
+                decreaseKey##Suffix(&heap, v, dist[v]);                                         \
+                updates++;                                                                      \
+            }                                                                                   \
+        }                                                                                       \
+    }                                                                                           \
+    free##Name(&heap);                                                                          \
+    return updates;                                                                             \
+}
+
+DEFINE_DIJKSTRA(BinaryHeap, Binary)
+DEFINE_DIJKSTRA(QuadHeap, Quad)
+
+double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * DEFINE_HEAP_BENCHMARK: The heap workloads, once per heap type. Each returns the elapsed time
+ * and adds the popped keys to *check, so both heaps can be compared for the same result.
+ *   pushPopX:     push n elements one by one, then pop them all
+ *   heapifyPopX:  build the heap from the same n elements in O(n), then pop them all
+ *   decreaseX:    build, lower the keys of n random ids, then pop them all
+ */
+#define DEFINE_HEAP_BENCHMARK(Name, Suffix)                                                     \
+double pushPop##Suffix(const HeapEntry* values, int n, long long* check) {                      \
+    Name heap;                                                                                  \
+    init##Name(&heap, n);                                                                       \
+    double start = nowSeconds();                                                                \
+    for (int i = 0; i < n; i++) {                                                               \
+        push##Suffix(&heap, values[i].id, values[i].key);                                       \
+    }                                                                                           \
+    int key, previous = INT_MIN;                                                                \
+    while (!isEmpty##Suffix(&heap)) {                                                           \
+        pop##Suffix(&heap, &key);                                                               \
+        *check += key < previous ? -1000000000LL : key; /* Keys must come out sorted. */        \
+        previous = key;                                                                         \
+    }                                                                                           \
+    double elapsed = nowSeconds() - start;                                                      \
+    free##Name(&heap);                                                                          \
+    return elapsed;                                                                             \
+}                                                                                               \
+                                                                                                \
+double heapifyPop##Suffix(const HeapEntry* values, int n, long long* check) {                   \
+    Name heap;                                                                                  \
+    init##Name(&heap, n);                                                                       \
+    double start = nowSeconds();                                                                \
+    build##Suffix(&heap, values, n);                                                            \
+    int key, previous = INT_MIN;                                                                \
+    while (!isEmpty##Suffix(&heap)) {                                                           \
+        pop##Suffix(&heap, &key);                                                               \
+        *check += key < previous ? -1000000000LL : key;                                         \
+        previous = key;                                                                         \
+    }                                                                                           \
+    double elapsed = nowSeconds() - start;                                                      \
+    free##Name(&heap);                                                                          \
+    return elapsed;                                                                             \
+}                                                                                               \
+                                                                                                \
+double decrease##Suffix(const HeapEntry* values, int n, long long* check) {                     \
+    Name heap;                                                                                  \
+    init##Name(&heap, n);                                                                       \
+    build##Suffix(&heap, values, n);                                                            \
+    srand(7);                                                                                   \
+    double start = nowSeconds();                                                                \
+    for (int i = 0; i < n; i++) {                                                               \
+        int id = rand() % n;                                                                    \
+        int position = heap.position[id];                                                       \
+        decreaseKey##Suffix(&heap, id, heap.entries[position].key / 2);                         \
+    }                                                                                           \
+    int key, previous = INT_MIN;                                                                \
+    while (!isEmpty##Suffix(&heap)) {                                                           \
+        pop##Suffix(&heap, &key);                                                               \
+        *check += key < previous ? -1000000000LL : key;                                         \
+        previous = key;                                                                         \
+    }                                                                                           \
+    double elapsed = nowSeconds() - start;                                                      \
+    free##Name(&heap);                                                                          \
+    return elapsed;                                                                             \
+}
+
+DEFINE_HEAP_BENCHMARK(BinaryHeap, Binary)
+DEFINE_HEAP_BENCHMARK(QuadHeap, Quad)
+
+/*
+ * benchmark: Runs every workload on both heaps with n random keys, then Dijkstra on a random graph.
+ */
+void benchmark(int n, int vertices, int degree) {
+    HeapEntry* values = (HeapEntry*)malloc((size_t)n * sizeof(HeapEntry));
+    if (values == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    srand(42);
+    for (int i = 0; i < n; i++) {
+        values[i].key = rand();
+        values[i].id = i;
+    }
+    printf("%d elements with random keys (%.1f MB of heap)\n", n, n * sizeof(HeapEntry) / 1e6);
+    printf("workload              binary (ms)   4-ary (ms)   speedup\n");
+    const char* names[] = { "push + pop", "heapify + pop", "decrease-key + pop" };
+    double (*binary[])(const HeapEntry*, int, long long*) = { pushPopBinary, heapifyPopBinary, decreaseBinary };
+    double (*quad[])(const HeapEntry*, int, long long*) = { pushPopQuad, heapifyPopQuad, decreaseQuad };
+    for (int w = 0; w < 3; w++) {
+        long long binaryCheck = 0, quadCheck = 0;
+        double binaryTime = binary[w](values, n, &binaryCheck);
+        double quadTime = quad[w](values, n, &quadCheck);
+        printf("%-18s   %12.1f   %10.1f   %6.2fx%s\n", names[w], binaryTime * 1e3, quadTime * 1e3,
+               binaryTime / quadTime, binaryCheck == quadCheck ? "" : "   RESULTS DIFFER");
+    }
+    free(values);
+
+    // Dijkstra on a random graph with weights 1..100.
+    Graph* graph = createGraph(vertices);
+    for (int v = 0; v < vertices; v++) {
+        for (int e = 0; e < degree / 2; e++) {
+            int u = rand() % vertices;
+            if (u != v) {
+                addWeightedEdge(graph, v, u, 1 + rand() % 100);
+            }
+        }
+    }
+    int* binaryDist = (int*)malloc(vertices * sizeof(int));
+    int* quadDist = (int*)malloc(vertices * sizeof(int));
+    if (binaryDist == NULL || quadDist == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    double start = nowSeconds();
+    long long updates = dijkstraBinary(graph, 0, binaryDist);
+    double binaryTime = nowSeconds() - start;
+    start = nowSeconds();
+    dijkstraQuad(graph, 0, quadDist);
+    double quadTime = nowSeconds() - start;
+    int same = 1;
+    for (int v = 0; v < vertices; v++) {
+        same &= binaryDist[v] == quadDist[v];
+    }
+    printf("%-18s   %12.1f   %10.1f   %6.2fx%s\n", "Dijkstra", binaryTime * 1e3, quadTime * 1e3,
+           binaryTime / quadTime, same ? "" : "   RESULTS DIFFER");
+    printf("  (%d vertices, about %d edges each, %lld decrease-keys)\n", vertices, degree, updates);
+    free(binaryDist);
+    free(quadDist);
+    freeGraph(graph);
+}
+
+// Main function to demonstrate the priority queue operations and run the benchmark.
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 21;
+    if (n <= 0) {
+        printf("Usage: %s [elements]\n", argv[0]);
+        return 1;
+    }
+
+    // Ids 0..7 with keys; the smallest key comes out first.
+    QuadHeap heap;
+    initQuadHeap(&heap, 8);
+    HeapEntry tasks[] = { { 50, 0 }, { 20, 1 }, { 70, 2 }, { 10, 3 } };
+    buildQuad(&heap, tasks, 4);
+    HeapEntry more[] = { { 40, 4 }, { 60, 5 } };
+    pushManyQuad(&heap, more, 2);
+    pushQuad(&heap, 6, 30);
+    printf("Heap of %d elements, smallest key %d (id %d)\n", sizeQuad(&heap), topQuad(&heap).key,
+           topQuad(&heap).id);
+    decreaseKeyQuad(&heap, 2, 5);
+    printf("After lowering the key of id 2 to 5:");
+    while (!isEmptyQuad(&heap)) {
+        int key;
+        int id = popQuad(&heap, &key);
+        printf(" %d(id %d)", key, id);
+    }
+    printf("\n");
+    freeQuadHeap(&heap);
+
+    // Shortest paths on a small weighted graph.
+    Graph* graph = createGraph(5);
+    addWeightedEdge(graph, 0, 1, 4);
+    addWeightedEdge(graph, 0, 4, 1);
+    addWeightedEdge(graph, 1, 2, 2);
+    addWeightedEdge(graph, 1, 3, 5);
+    addWeightedEdge(graph, 4, 1, 2);
+    addWeightedEdge(graph, 2, 3, 1);
+    int dist[5];
+    dijkstraBinary(graph, 0, dist);
+    printf("Shortest distances from vertex 0:");
+    for (int v = 0; v < 5; v++) {
+        printf(" %d", dist[v]);
+    }
+    printf("\n\n");
+    freeGraph(graph);
+
+    benchmark(n, 4000, 200);
+    return 0;
+}
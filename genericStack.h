@@ -0,0 +1,167 @@
+#ifndef GENERIC_STACK_H
+#define GENERIC_STACK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * genericStack.h: One stack implementation for every element type, generated at compile time.
+ * Explanation: DEFINE_STACK(Name, Type, Suffix, InlineCapacity) expands to a stack type Name that
+ * holds elements of Type, plus its operations as static inline functions. Every instantiation is
+ * ordinary type-specific code, so the compiler inlines push and pop and knows sizeof(Type) in
+ * every memcpy. The stack is the growable array stack of 05:
+ *   - the first InlineCapacity elements are stored inside the stack itself, so shallow stacks
+ *     never allocate;
+ *   - after that the elements move to a heap block that doubles whenever it is full;
+ *   - items may point into the stack itself, so a stack must not be copied by value.
+ *
+ * The function names are built from Name and Suffix, matching the names the programs already use:
+ *   DEFINE_STACK(Stack, int, , 16)          -> initStack, push, pop, peek, isEmpty, ...   (05)
+ *   DEFINE_STACK(CharStack, char, Char, 64) -> initCharStack, pushChar, popChar, ...      (06)
+ *
+ * Generated functions (S is Name, x is Suffix):
+ *   initS, freeS                 set up an empty stack / release its heap block
+ *   reserveX, shrinkToFitX       grow to a capacity up front / give unused memory back
+ *   isEmptyX, isFullX, sizeX     state queries (isFull: the next push has to grow)
+ *   pushX, popX, peekX           single elements; pop and peek on an empty stack exit
+ *   pushManyX, popManyX          whole arrays with one memcpy
+ */
+
+// Message and exit used when an element is requested from an empty stack.
+#define STACK_UNDERFLOW()                                                                       \
+    do { printf("Stack underflow\n"); exit(1); } while (0)
+
+#define DEFINE_STACK(Name, Type, Suffix, InlineCapacity)                                        \
+                                                                                                \
+typedef struct {                                                                                \
+    Type* items;                          /* inlineItems or a heap block. */                    \
+    int top;                              /* Index of the top element, -1 when empty. */        \
+    int capacity;                         /* Number of elements items can hold. */              \
+    Type inlineItems[InlineCapacity];     /* Small buffer used until the stack outgrows it. */  \
+} Name;                                                                                         \
+                                                                                                \
+/* Sets the top index to -1 and points the stack at its inline buffer. */                       \
+static inline void init##Name(Name* s) {                                                        \
+    s->items = s->inlineItems;                                                                  \
+    s->top = -1;                                                                                \
+    s->capacity = InlineCapacity;                                                               \
+}                                                                                               \
+                                                                                                \
+/* Releases the heap block, if any, and leaves the stack empty. */                              \
+static inline void free##Name(Name* s) {                                                        \
+    if (s->items != s->inlineItems) {                                                           \
+        free(s->items);                                                                         \
+    }                                                                                           \
+    init##Name(s);                                                                              \
+}                                                                                               \
+                                                                                                \
+/* Makes room for at least capacity elements, doubling the current capacity until it fits.      \
+   Not inline: it is the rare slow path of push and should stay out of the caller's loop. */    \
+static void reserve##Suffix(Name* s, int capacity) {                                            \
+    if (capacity <= s->capacity) {                                                              \
+        return;                                                                                 \
+    }                                                                                           \
+    int newCapacity = s->capacity;                                                              \
+    while (newCapacity < capacity) {                                                            \
+        newCapacity *= 2;                                                                       \
+    }                                                                                           \
+    Type* items;                                                                                \
+    if (s->items == s->inlineItems) {                                                           \
+        items = (Type*)malloc((size_t)newCapacity * sizeof(Type));                              \
+        if (items != NULL) {                                                                    \
+            memcpy(items, s->inlineItems, (size_t)(s->top + 1) * sizeof(Type));                 \
+        }                                                                                       \
+    } else {                                                                                    \
+        items = (Type*)realloc(s->items, (size_t)newCapacity * sizeof(Type));                   \
+    }                                                                                           \
+    if (items == NULL) {                                                                        \
+        printf("Memory allocation failed.\n");                                                  \
+        exit(1);                                                                                \
+    }                                                                                           \
+    s->items = items;                                                                           \
+    s->capacity = newCapacity;                                                                  \
+}                                                                                               \
+                                                                                                \
+/* Moves a stack that fits again back into its inline buffer, or trims its heap block. */       \
+static inline void shrinkToFit##Suffix(Name* s) {                                               \
+    if (s->items == s->inlineItems) {                                                           \
+        return;                                                                                 \
+    }                                                                                           \
+    int count = s->top + 1;                                                                     \
+    if (count <= InlineCapacity) {                                                              \
+        memcpy(s->inlineItems, s->items, (size_t)count * sizeof(Type));                         \
+        free(s->items);                                                                         \
+        s->items = s->inlineItems;                                                              \
+        s->capacity = InlineCapacity;                                                           \
+    } else if (count < s->capacity) {                                                           \
+        Type* items = (Type*)realloc(s->items, (size_t)count * sizeof(Type));                   \
+        if (items != NULL) { /* If realloc fails, the larger block is simply kept. */           \
+            s->items = items;                                                                   \
+            s->capacity = count;                                                                \
+        }                                                                                       \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static inline int isEmpty##Suffix(Name* s) {                                                    \
+    return s->top == -1;                                                                        \
+}                                                                                               \
+                                                                                                \
+static inline int isFull##Suffix(Name* s) {                                                     \
+    return s->top == s->capacity - 1;                                                           \
+}                                                                                               \
+                                                                                                \
+static inline int size##Suffix(Name* s) {                                                       \
+    return s->top + 1;                                                                          \
+}                                                                                               \
+                                                                                                \
+/* Works on a local copy of top so the store through items does not force a reload. */          \
+static inline void push##Suffix(Name* s, Type value) {                                          \
+    int top = s->top + 1;                                                                       \
+    if (top == s->capacity) {                                                                   \
+        reserve##Suffix(s, top + 1);                                                            \
+    }                                                                                           \
+    s->items[top] = value;                                                                      \
+    s->top = top;                                                                               \
+}                                                                                               \
+                                                                                                \
+static inline Type pop##Suffix(Name* s) {                                                       \
+    int top = s->top;                                                                           \
+    if (top == -1) {                                                                            \
+        STACK_UNDERFLOW();                                                                      \
+    }                                                                                           \
+    s->top = top - 1;                                                                           \
+    return s->items[top];                                                                       \
+}                                                                                               \
+                                                                                                \
+static inline Type peek##Suffix(Name* s) {                                                      \
+    if (s->top == -1) {                                                                         \
+        STACK_UNDERFLOW();                                                                      \
+    }                                                                                           \
+    return s->items[s->top];                                                                    \
+}                                                                                               \
+                                                                                                \
+/* Pushes count elements; values[count - 1] ends up on top, as if pushed one by one. */         \
+static inline void pushMany##Suffix(Name* s, const Type* values, int count) {                   \
+    if (count <= 0) {                                                                           \
+        return;                                                                                 \
+    }                                                                                           \
+    reserve##Suffix(s, s->top + 1 + count);                                                     \
+    memcpy(&s->items[s->top + 1], values, (size_t)count * sizeof(Type));                        \
+    s->top += count;                                                                            \
+}                                                                                               \
+                                                                                                \
+/* Pops up to count elements in push order (old top last) and returns how many were popped. */  \
+static inline int popMany##Suffix(Name* s, Type* values, int count) {                           \
+    if (count > s->top + 1) {                                                                   \
+        count = s->top + 1;                                                                     \
+    }                                                                                           \
+    if (count <= 0) {                                                                           \
+        return 0;                                                                               \
+    }                                                                                           \
+    s->top -= count;                                                                            \
+    memcpy(values, &s->items[s->top + 1], (size_t)count * sizeof(Type));                        \
+    return count;                                                                               \
+}
+
+#endif // GENERIC_STACK_H
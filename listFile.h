@@ -0,0 +1,153 @@
+#ifndef LIST_FILE_H
+#define LIST_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * listFile.h: Flat binary checkpoint format shared by the linked list programs (02, 03, 04).
+ * Explanation: A list is stored as a 16-byte header followed by its values in list order:
+ *
+ *   offset 0   char     magic[4]    "LSTF"
+ *   offset 4   uint32_t valueSize   sizeof(int) of the writer
+ *   offset 8   uint64_t count       number of values that follow
+ *   offset 16  int      values[count]
+ *
+ * There are no pointers in the file, so it can be mapped with mmap and read in place: a
+ * loader walks the values array once and links the nodes as it goes. Values are stored in
+ * the byte order of the machine that wrote them.
+ * madvise needs _GNU_SOURCE, so define it before the first #include of a program using this file.
+ */
+
+#define LIST_FILE_MAGIC "LSTF"
+#define LIST_FILE_BUFFER 16384 // Values collected by a ListFileWriter before each fwrite.
+
+// Header at the start of every list file.
+typedef struct {
+    char magic[4];             // LIST_FILE_MAGIC, identifies the format.
+    uint32_t valueSize;        // Size of one stored value in bytes.
+    uint64_t count;            // Number of values after the header.
+} ListFileHeader;
+
+// Buffered writer: values are appended one by one but written in large blocks.
+typedef struct {
+    FILE* file;                    // Output file.
+    size_t used;                   // Values currently held in buffer.
+    int buffer[LIST_FILE_BUFFER];  // Values not written yet.
+} ListFileWriter;
+
+// A list file mapped into memory by listFileMap.
+typedef struct {
+    void* base;                // Start of the mapping.
+    size_t length;             // Length of the mapping in bytes.
+    const int* values;         // First stored value, right after the header.
+    uint64_t count;            // Number of stored values.
+} ListFileMapping;
+
+/*
+ * listFileCreate: Creates (or truncates) a list file and writes its header.
+ * Explanation: The number of values must be known up front; every list keeps its size, so it is.
+ * Returns 0 on success and -1 if the file cannot be written.
+ */
+static inline int listFileCreate(ListFileWriter* writer, const char* path, uint64_t count) {
+    ListFileHeader header;
+    memcpy(header.magic, LIST_FILE_MAGIC, 4);
+    header.valueSize = sizeof(int);
+    header.count = count;
+    writer->used = 0;
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        printf("Cannot create %s.\n", path);
+        return -1;
+    }
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        printf("Cannot write %s.\n", path);
+        fclose(writer->file);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * listFilePut: Appends one value, writing the buffer out when it is full.
+ * Explanation: Write errors are remembered by the FILE and reported by listFileClose.
+ */
+static inline void listFilePut(ListFileWriter* writer, int value) {
+    writer->buffer[writer->used++] = value;
+    if (writer->used == LIST_FILE_BUFFER) {
+        fwrite(writer->buffer, sizeof(int), LIST_FILE_BUFFER, writer->file);
+        writer->used = 0;
+    }
+}
+
+/*
+ * listFileClose: Writes the remaining values and closes the file.
+ * Returns 0 on success and -1 if any write failed.
+ */
+static inline int listFileClose(ListFileWriter* writer) {
+    if (writer->used > 0) {
+        fwrite(writer->buffer, sizeof(int), writer->used, writer->file);
+    }
+    int failed = ferror(writer->file);
+    if (fclose(writer->file) != 0 || failed) {
+        printf("Writing the list file failed.\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * listFileMap: Maps a list file read-only and checks its header.
+ * Explanation: The values are not copied; mapping->values points into the page cache.
+ * MADV_SEQUENTIAL tells the kernel to read ahead, since loaders walk the file front to back.
+ * Returns 0 on success and -1 if the file is missing, truncated or not a list file.
+ */
+static inline int listFileMap(ListFileMapping* mapping, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Cannot open %s.\n", path);
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ListFileHeader)) {
+        printf("%s is not a list file.\n", path);
+        close(fd);
+        return -1;
+    }
+    mapping->length = (size_t)info.st_size;
+    mapping->base = mmap(NULL, mapping->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed.
+    if (mapping->base == MAP_FAILED) {
+        printf("Cannot map %s.\n", path);
+        return -1;
+    }
+    const ListFileHeader* header = (const ListFileHeader*)mapping->base;
+    if (memcmp(header->magic, LIST_FILE_MAGIC, 4) != 0 || header->valueSize != sizeof(int)
+        || header->count != (mapping->length - sizeof(ListFileHeader)) / sizeof(int)
+        || (mapping->length - sizeof(ListFileHeader)) % sizeof(int) != 0) {
+        printf("%s is not a list file or is truncated.\n", path);
+        munmap(mapping->base, mapping->length);
+        return -1;
+    }
+    madvise(mapping->base, mapping->length, MADV_SEQUENTIAL);
+    mapping->values = (const int*)((const char*)mapping->base + sizeof(ListFileHeader));
+    mapping->count = header->count;
+    return 0;
+}
+
+/*
+ * listFileUnmap: Releases a mapping created by listFileMap.
+ */
+static inline void listFileUnmap(ListFileMapping* mapping) {
+    munmap(mapping->base, mapping->length);
+    mapping->base = NULL;
+    mapping->values = NULL;
+    mapping->count = 0;
+}
+
+#endif // LIST_FILE_H
@@ -0,0 +1,235 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/*
+ * nodePool.h: A fixed-size node allocator shared by the linked list and tree programs.
+ * Explanation: Instead of calling malloc/free for every node, the pool carves nodes out of
+ * large slabs and recycles freed nodes through a free list that is threaded through the
+ * freed nodes themselves. Every node of a pool can be released at once with poolReleaseAll.
+ *
+ * A program opts in by compiling with -DUSE_NODE_POOL (see 02, 03, 04 and 08).
+ * A single pool is not thread-safe on its own: when several threads share a pool, each thread
+ * must allocate and free through its own PoolCache, which talks to the pool under its lock.
+ */
+
+#define POOL_ALIGN 16                // Every node is aligned like malloc'ed memory.
+#define POOL_DEFAULT_SLAB_NODES 1024 // Nodes carved out of each slab.
+#define POOL_CACHE_BATCH 64          // Nodes moved between a PoolCache and its pool at once.
+
+// Rounds a node size up so that consecutive nodes in a slab stay aligned.
+#define POOL_ROUND_SIZE(size) ((((size) < sizeof(void*) ? sizeof(void*) : (size)) + POOL_ALIGN - 1) \
+                               / POOL_ALIGN * POOL_ALIGN)
+
+// Static initializer for a pool of nodes of the given size, e.g.
+//   static NodePool pool = NODE_POOL_INITIALIZER(sizeof(struct Node));
+#define NODE_POOL_INITIALIZER(size) \
+    { POOL_ROUND_SIZE(size), POOL_DEFAULT_SLAB_NODES, NULL, NULL, NULL, NULL, 0, PTHREAD_MUTEX_INITIALIZER }
+
+// A slab is one large malloc'ed block; the header links all slabs so they can be freed together.
+typedef struct PoolSlab {
+    struct PoolSlab* next;     // Next slab owned by the same pool.
+} PoolSlab;
+
+// A freed node is reused to store the link to the next free node.
+typedef struct PoolFreeNode {
+    struct PoolFreeNode* next; // Next node on the free list.
+} PoolFreeNode;
+
+typedef struct {
+    size_t nodeSize;           // Size of one node, rounded up to POOL_ALIGN.
+    size_t nodesPerSlab;       // Number of nodes in each new slab.
+    PoolSlab* slabs;           // All slabs allocated by the pool.
+    PoolFreeNode* freeList;    // Nodes that were freed and can be handed out again.
+    char* bump;                // Next never-used node in the newest slab.
+    char* bumpEnd;             // End of the newest slab.
+    size_t liveNodes;          // Nodes currently handed out, counting those held by PoolCaches.
+    pthread_mutex_t lock;      // Guards the pool when PoolCaches of several threads share it.
+} NodePool;
+
+// Per-thread magazine of free nodes in front of a shared pool.
+typedef struct {
+    NodePool* pool;            // Pool the cache refills from and flushes to.
+    PoolFreeNode* freeList;    // Nodes owned by this thread only.
+    size_t count;              // Number of nodes on freeList.
+} PoolCache;
+
+// Offset of the first node in a slab; keeps nodes aligned after the slab header.
+#define POOL_SLAB_HEADER POOL_ROUND_SIZE(sizeof(PoolSlab))
+
+/*
+ * poolInit: Initializes a pool for nodes of the given size.
+ * Explanation: No memory is allocated until the first node is requested.
+ */
+static inline void poolInit(NodePool* pool, size_t nodeSize, size_t nodesPerSlab) {
+    pool->nodeSize = POOL_ROUND_SIZE(nodeSize);
+    pool->nodesPerSlab = nodesPerSlab > 0 ? nodesPerSlab : POOL_DEFAULT_SLAB_NODES;
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    pool->bump = pool->bumpEnd = NULL;
+    pool->liveNodes = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+}
+
+/*
+ * poolGrow: Allocates a new slab of the given number of nodes and makes it the bump region.
+ * Explanation: Nodes of the new slab are handed out in address order, so a structure that
+ * is built in one go ends up contiguous in memory.
+ */
+static inline void poolGrow(NodePool* pool, size_t nodes) {
+    PoolSlab* slab = (PoolSlab*)malloc(POOL_SLAB_HEADER + pool->nodeSize * nodes);
+    if (slab == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->bump = (char*)slab + POOL_SLAB_HEADER;
+    pool->bumpEnd = pool->bump + pool->nodeSize * nodes;
+}
+
+/*
+ * poolAlloc: Returns one uninitialized node from the pool.
+ * Explanation: Recently freed nodes are reused first (they are likely still in cache);
+ * otherwise the next node of the newest slab is taken, growing the pool when it runs out.
+ */
+static inline void* poolAlloc(NodePool* pool) {
+    PoolFreeNode* node = pool->freeList;
+    if (node != NULL) {
+        pool->freeList = node->next;
+    } else {
+        if (pool->bump == pool->bumpEnd) {
+            poolGrow(pool, pool->nodesPerSlab);
+        }
+        node = (PoolFreeNode*)pool->bump;
+        pool->bump += pool->nodeSize;
+    }
+    pool->liveNodes++;
+    return node;
+}
+
+/*
+ * poolAllocBlock: Returns count uninitialized nodes that lie back to back in memory.
+ * Explanation: Used by bulk builders that know the number of nodes up front. Node i starts
+ * i * nodeSize bytes after the returned address. When the newest slab has too little room
+ * left, a slab of at least count nodes is allocated and the rest of the old one stays unused
+ * until poolReleaseAll. Each node can still be returned on its own with poolFree.
+ */
+static inline void* poolAllocBlock(NodePool* pool, size_t count) {
+    if ((size_t)(pool->bumpEnd - pool->bump) < count * pool->nodeSize) {
+        poolGrow(pool, count > pool->nodesPerSlab ? count : pool->nodesPerSlab);
+    }
+    void* block = pool->bump;
+    pool->bump += count * pool->nodeSize;
+    pool->liveNodes += count;
+    return block;
+}
+
+/*
+ * poolFree: Returns a node to the pool's free list.
+ * Explanation: The memory stays owned by the pool; it is handed out again by the next poolAlloc.
+ */
+static inline void poolFree(NodePool* pool, void* ptr) {
+    PoolFreeNode* node = (PoolFreeNode*)ptr;
+    node->next = pool->freeList;
+    pool->freeList = node;
+    pool->liveNodes--;
+}
+
+/*
+ * poolReleaseAll: Releases every node of the pool in one call.
+ * Explanation: All slabs are freed at once, so tearing down a structure that owns the pool
+ * costs one free per slab instead of one per node. The pool can be used again afterwards.
+ */
+static inline void poolReleaseAll(NodePool* pool) {
+    PoolSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        PoolSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    pool->bump = pool->bumpEnd = NULL;
+    pool->liveNodes = 0;
+}
+
+/*
+ * poolDestroy: Releases all memory of the pool and its lock.
+ */
+static inline void poolDestroy(NodePool* pool) {
+    poolReleaseAll(pool);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+/*
+ * poolCacheInit: Attaches a per-thread cache to a shared pool.
+ */
+static inline void poolCacheInit(PoolCache* cache, NodePool* pool) {
+    cache->pool = pool;
+    cache->freeList = NULL;
+    cache->count = 0;
+}
+
+/*
+ * poolCacheAlloc: Returns one node, refilling the cache from the pool when it is empty.
+ * Explanation: The pool's lock is taken once per POOL_CACHE_BATCH nodes instead of once per node.
+ */
+static inline void* poolCacheAlloc(PoolCache* cache) {
+    if (cache->freeList == NULL) {
+        NodePool* pool = cache->pool;
+        pthread_mutex_lock(&pool->lock);
+        for (int i = 0; i < POOL_CACHE_BATCH; i++) {
+            PoolFreeNode* node = (PoolFreeNode*)poolAlloc(pool);
+            node->next = cache->freeList;
+            cache->freeList = node;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        cache->count = POOL_CACHE_BATCH;
+    }
+    PoolFreeNode* node = cache->freeList;
+    cache->freeList = node->next;
+    cache->count--;
+    return node;
+}
+
+/*
+ * poolCacheFlush: Hands every cached node back to the shared pool.
+ * Explanation: The pool counts the nodes a cache holds as handed out, so its liveNodes drops by
+ * the number flushed. Once every cache is flushed, liveNodes is exact again.
+ */
+static inline void poolCacheFlush(PoolCache* cache) {
+    if (cache->freeList == NULL) return;
+    NodePool* pool = cache->pool;
+    PoolFreeNode* last = cache->freeList;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    pthread_mutex_lock(&pool->lock);
+    last->next = pool->freeList;
+    pool->freeList = cache->freeList;
+    pool->liveNodes -= cache->count;
+    pthread_mutex_unlock(&pool->lock);
+    cache->freeList = NULL;
+    cache->count = 0;
+}
+
+/*
+ * poolCacheFree: Returns a node to the thread's cache.
+ * Explanation: When the cache holds two batches, it flushes them back to the pool so that
+ * memory freed by one thread can be reused by the others.
+ */
+static inline void poolCacheFree(PoolCache* cache, void* ptr) {
+    PoolFreeNode* node = (PoolFreeNode*)ptr;
+    node->next = cache->freeList;
+    cache->freeList = node;
+    if (++cache->count >= 2 * POOL_CACHE_BATCH) {
+        poolCacheFlush(cache);
+    }
+}
+
+#endif // NODE_POOL_H
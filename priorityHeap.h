@@ -0,0 +1,271 @@
+#ifndef PRIORITY_HEAP_H
+#define PRIORITY_HEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * priorityHeap.h: An array-backed d-ary min-heap priority queue, generated at compile time.
+ * Explanation: DEFINE_HEAP(Name, Suffix, Arity) expands to a heap type Name whose nodes have Arity
+ * children, plus its operations as static inline functions, in the same way as genericStack.h.
+ * Every element is an id (0 .. maxIds - 1, for example a vertex number) with an int key; the
+ * smallest key is at the root. A position index maps every id to its slot in the array, so the
+ * key of an id that is already in the heap can be lowered in O(log n) (decrease-key), which is
+ * what Dijkstra's algorithm needs.
+ *   DEFINE_HEAP(BinaryHeap, Binary, 2) -> initBinaryHeap, pushBinary, popBinary, ...
+ *   DEFINE_HEAP(QuadHeap, Quad, 4)     -> initQuadHeap, pushQuad, popQuad, ...
+ *
+ * Cache layout: the children of node i are nodes Arity*i + 1 .. Arity*i + Arity. The array is
+ * aligned to a cache line and the root is stored at slot Arity - 1, so node i lives in slot
+ * i + Arity - 1 and the children of every node start at a multiple of Arity. With 8-byte elements,
+ * the 4 children of a 4-ary node fill half a cache line and never straddle two, so a sift-down
+ * step reads one line; the heap is also half as deep as a binary one.
+ *
+ * Generated functions (H is Name, x is Suffix):
+ *   initH, freeH                 set up an empty heap for ids below maxIds / release it
+ *   isEmptyX, sizeX, containsX   state queries
+ *   pushX, popX, topX            single elements; pop and top on an empty heap exit
+ *   decreaseKeyX                 lower the key of an id, or insert it if it is not in the heap
+ *   buildX                       replace the contents with an array in O(n) (heapify)
+ *   pushManyX                    add an array of elements, re-heapifying when that is cheaper
+ */
+
+// One element: an id and its priority. Smaller keys come out first.
+typedef struct {
+    int key;
+    int id;
+} HeapEntry;
+
+#define HEAP_CACHE_LINE 64          // Alignment of the element array.
+#define HEAP_INITIAL_CAPACITY 16    // Elements a new heap has room for.
+
+// Message and exit used for an empty heap or a bad id.
+#define HEAP_ERROR(message)                                                                     \
+    do { printf("%s\n", message); exit(1); } while (0)
+
+#define DEFINE_HEAP(Name, Suffix, Arity)                                                        \
+                                                                                                \
+typedef struct {                                                                                \
+    HeapEntry* block;               /* Cache-line aligned allocation. */                        \
+    HeapEntry* entries;             /* block + Arity - 1; entries[0] is the root. */            \
+    int size;                       /* Number of elements. */                                   \
+    int capacity;                   /* Elements entries can hold. */                            \
+    int* position;                  /* Index of every id in entries, -1 if not in the heap. */  \
+    int maxIds;                     /* Ids are 0 .. maxIds - 1. */                              \
+} Name;                                                                                         \
+                                                                                                \
+/* Allocates room for capacity elements behind Arity - 1 unused slots, rounded up to whole      \
+   cache lines, and copies the current elements over. */                                        \
+static void reserve##Suffix(Name* h, int capacity) {                                            \
+    if (capacity <= h->capacity) {                                                              \
+        return;                                                                                 \
+    }                                                                                           \
+    int newCapacity = h->capacity > 0 ? h->capacity : HEAP_INITIAL_CAPACITY;                    \
+    while (newCapacity < capacity) {                                                            \
+        newCapacity *= 2;                                                                       \
+    }                                                                                           \
+    size_t bytes = (size_t)(newCapacity + Arity - 1) * sizeof(HeapEntry);                       \
+    bytes = (bytes + HEAP_CACHE_LINE - 1) / HEAP_CACHE_LINE * HEAP_CACHE_LINE;                  \
+    HeapEntry* block = (HeapEntry*)aligned_alloc(HEAP_CACHE_LINE, bytes);                       \
+    if (block == NULL) {                                                                        \
+        printf("Memory allocation failed.\n");                                                  \
+        exit(1);                                                                                \
+    }                                                                                           \
+    if (h->size > 0) {                                                                          \
+        memcpy(block + Arity - 1, h->entries, (size_t)h->size * sizeof(HeapEntry));             \
+    }                                                                                           \
+    free(h->block);                                                                             \
+    h->block = block;                                                                           \
+    h->entries = block + Arity - 1;                                                             \
+    h->capacity = newCapacity;                                                                  \
+}                                                                                               \
+                                                                                                \
+/* Sets up an empty heap for the ids 0 .. maxIds - 1. */                                        \
+static inline void init##Name(Name* h, int maxIds) {                                            \
+    h->block = NULL;                                                                            \
+    h->entries = NULL;                                                                          \
+    h->size = 0;                                                                                \
+    h->capacity = 0;                                                                            \
+    h->maxIds = maxIds;                                                                         \
+    h->position = (int*)malloc((size_t)(maxIds > 0 ? maxIds : 1) * sizeof(int));                \
+    if (h->position == NULL) {                                                                  \
+        printf("Memory allocation failed.\n");                                                  \
+        exit(1);                                                                                \
+    }                                                                                           \
+    memset(h->position, 0xff, (size_t)maxIds * sizeof(int)); /* Every id at -1. */              \
+    reserve##Suffix(h, HEAP_INITIAL_CAPACITY);                                                  \
+}                                                                                               \
+                                                                                                \
+static inline void free##Name(Name* h) {                                                        \
+    free(h->block);                                                                             \
+    free(h->position);                                                                          \
+    h->block = h->entries = NULL;                                                               \
+    h->position = NULL;                                                                         \
+    h->size = h->capacity = 0;                                                                  \
+}                                                                                               \
+                                                                                                \
+static inline int isEmpty##Suffix(Name* h) {                                                    \
+    return h->size == 0;                                                                        \
+}                                                                                               \
+                                                                                                \
+static inline int size##Suffix(Name* h) {                                                       \
+    return h->size;                                                                             \
+}                                                                                               \
+                                                                                                \
+static inline int contains##Suffix(Name* h, int id) {                                           \
+    return h->position[id] >= 0;                                                                \
+}                                                                                               \
+                                                                                                \
+/* Moves e up from index i past every parent with a larger key. The parents move down into      \
+   the hole, and e is stored once at the end. */                                                \
+static inline void siftUp##Suffix(Name* h, int i, HeapEntry e) {                                \
+    HeapEntry* entries = h->entries;                                                            \
+    while (i > 0) {                                                                             \
+        int parent = (i - 1) / Arity;                                                           \
+        if (entries[parent].key <= e.key) {                                                     \
+            break;                                                                              \
+        }                                                                                       \
+        entries[i] = entries[parent];                                                           \
+        h->position[entries[i].id] = i;                                                         \
+        i = parent;                                                                             \
+    }                                                                                           \
+    entries[i] = e;                                                                             \
+    h->position[e.id] = i;                                                                      \
+}                                                                                               \
+                                                                                                \
+/* Moves e down from index i, each time swapping in the smallest of the Arity children. */      \
+static inline void siftDown##Suffix(Name* h, int i, HeapEntry e) {                              \
+    HeapEntry* entries = h->entries;                                                            \
+    int size = h->size;                                                                         \
+    for (;;) {                                                                                  \
+        int first = Arity * i + 1;                                                              \
+        if (first >= size) {                                                                    \
+            break;                                                                              \
+        }                                                                                       \
+        int last = first + Arity < size ? first + Arity : size;                                 \
+        int best = first;                                                                       \
+        for (int c = first + 1; c < last; c++) {                                                \
+            if (entries[c].key < entries[best].key) {                                           \
+                best = c;                                                                       \
+            }                                                                                   \
+        }                                                                                       \
+        if (entries[best].key >= e.key) {                                                       \
+            break;                                                                              \
+        }                                                                                       \
+        entries[i] = entries[best];                                                             \
+        h->position[entries[i].id] = i;                                                         \
+        i = best;                                                                               \
+    }                                                                                           \
+    entries[i] = e;                                                                             \
+    h->position[e.id] = i;                                                                      \
+}                                                                                               \
+                                                                                                \
+/* Adds id with key; id must not be in the heap yet. */                                         \
+static inline void push##Suffix(Name* h, int id, int key) {                                     \
+    if (id < 0 || id >= h->maxIds || h->position[id] >= 0) {                                    \
+        HEAP_ERROR("Invalid or duplicate heap id");                                             \
+    }                                                                                           \
+    if (h->size == h->capacity) {                                                               \
+        reserve##Suffix(h, h->size + 1);                                                        \
+    }                                                                                           \
+    HeapEntry e = { key, id };                                                                  \
+    siftUp##Suffix(h, h->size++, e);                                                            \
+}                                                                                               \
+                                                                                                \
+static inline HeapEntry top##Suffix(Name* h) {                                                  \
+    if (h->size == 0) {                                                                         \
+        HEAP_ERROR("Heap underflow");                                                           \
+    }                                                                                           \
+    return h->entries[0];                                                                       \
+}                                                                                               \
+                                                                                                \
+/* Removes the element with the smallest key, stores its key in *key (if not NULL) and returns  \
+   its id. The last element takes the root's place and sifts down. */                           \
+static inline int pop##Suffix(Name* h, int* key) {                                              \
+    if (h->size == 0) {                                                                         \
+        HEAP_ERROR("Heap underflow");                                                           \
+    }                                                                                           \
+    HeapEntry root = h->entries[0];                                                             \
+    h->position[root.id] = -1;                                                                  \
+    HeapEntry last = h->entries[--h->size];                                                     \
+    if (h->size > 0) {                                                                          \
+        siftDown##Suffix(h, 0, last);                                                           \
+    }                                                                                           \
+    if (key != NULL) {                                                                          \
+        *key = root.key;                                                                        \
+    }                                                                                           \
+    return root.id;                                                                             \
+}                                                                                               \
+                                                                                                \
+/* Lowers the key of id to key and returns 1. Returns 0 if id already has a key that is not     \
+   larger. An id that is not in the heap is pushed, which suits Dijkstra's algorithm. */        \
+static inline int decreaseKey##Suffix(Name* h, int id, int key) {                              \
+    if (id < 0 || id >= h->maxIds) {                                                            \
+        HEAP_ERROR("Invalid or duplicate heap id");                                             \
+    }                                                                                           \
+    int i = h->position[id];                                                                    \
+    if (i < 0) {                                                                                \
+        push##Suffix(h, id, key);                                                               \
+        return 1;                                                                               \
+    }                                                                                           \
+    if (h->entries[i].key <= key) {                                                             \
+        return 0;                                                                               \
+    }                                                                                           \
+    HeapEntry e = { key, id };                                                                  \
+    siftUp##Suffix(h, i, e);                                                                    \
+    return 1;                                                                                   \
+}                                                                                               \
+                                                                                                \
+/* Restores the heap order over the whole array, bottom-up from the last parent. Most nodes     \
+   are near the leaves and sift down only a level or two, so this is O(n) in total. */          \
+static inline void heapify##Suffix(Name* h) {                                                   \
+    for (int i = (h->size - 2) / Arity; i >= 0 && h->size > 1; i--) {                           \
+        siftDown##Suffix(h, i, h->entries[i]);                                                  \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+/* Appends count elements without ordering them and records their positions. */                \
+static inline void append##Suffix(Name* h, const HeapEntry* values, int count) {                \
+    reserve##Suffix(h, h->size + count);                                                        \
+    for (int k = 0; k < count; k++) {                                                           \
+        int id = values[k].id;                                                                  \
+        if (id < 0 || id >= h->maxIds || h->position[id] >= 0) {                               \
+            HEAP_ERROR("Invalid or duplicate heap id");                                         \
+        }                                                                                       \
+        h->entries[h->size] = values[k];                                                        \
+        h->position[id] = h->size++;                                                            \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+/* Replaces the contents of the heap with count elements in O(count). */                        \
+static inline void build##Suffix(Name* h, const HeapEntry* values, int count) {                 \
+    for (int k = 0; k < h->size; k++) {                                                         \
+        h->position[h->entries[k].id] = -1;                                                     \
+    }                                                                                           \
+    h->size = 0;                                                                                \
+    if (count <= 0) {                                                                           \
+        return;                                                                                 \
+    }                                                                                           \
+    append##Suffix(h, values, count);                                                           \
+    heapify##Suffix(h);                                                                         \
+}                                                                                               \
+                                                                                                \
+/* Adds count elements. A batch at least as large as the heap is appended and the whole array   \
+   is heapified (O(size + count)); a smaller one is sifted up element by element. */            \
+static inline void pushMany##Suffix(Name* h, const HeapEntry* values, int count) {              \
+    if (count <= 0) {                                                                           \
+        return;                                                                                 \
+    }                                                                                           \
+    if (count >= h->size) {                                                                     \
+        append##Suffix(h, values, count);                                                       \
+        heapify##Suffix(h);                                                                     \
+        return;                                                                                 \
+    }                                                                                           \
+    reserve##Suffix(h, h->size + count);                                                        \
+    for (int k = 0; k < count; k++) {                                                           \
+        push##Suffix(h, values[k].id, values[k].key);                                           \
+    }                                                                                           \
+}
+
+#endif // PRIORITY_HEAP_H
@@ -0,0 +1,229 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/*
+ * ringQueue.h: The queue of 07, shared with the programs that build on it.
+ * Explanation: Queue is a growable ring buffer of ints. All functions are static, so every
+ * program that includes this header gets its own copy and the compiler can inline them.
+ */
+
+#define QUEUE_INITIAL_CAPACITY 16  // Starting capacity of a queue, a power of two.
+
+/*
+ * Queue: A ring buffer that grows on demand.
+ * Explanation: The elements live in a circular array whose capacity is a power of two, so the slot
+ * of a position is found with a mask (position & mask) instead of a division. head and tail count
+ * every dequeue and enqueue ever made; they are never reset, they simply wrap around, and the
+ * number of elements is always tail - head (unsigned arithmetic keeps that right across the wrap).
+ * A dequeued slot is reused by a later enqueue, so a queue that is emptied as fast as it is filled
+ * never grows. When the array is full, the next enqueue moves the elements to an array twice as
+ * large, which keeps enqueue amortized O(1).
+ */
+typedef struct {
+    int* items;             // Circular array of capacity elements.
+    unsigned int capacity;  // Number of slots, a power of two.
+    unsigned int mask;      // capacity - 1.
+    unsigned int head;      // Position of the front element.
+    unsigned int tail;      // Position the next element is stored at.
+} Queue;
+
+/*
+ * createQueue: Allocates memory for a new queue and initializes its members.
+ * Returns a pointer to the newly created Queue.
+ */
+static inline Queue* createQueue(void) {
+    Queue* q = (Queue*)malloc(sizeof(Queue));
+    if (q != NULL) {
+        q->items = (int*)malloc(QUEUE_INITIAL_CAPACITY * sizeof(int));
+    }
+    if (q == NULL || q->items == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    q->capacity = QUEUE_INITIAL_CAPACITY;
+    q->mask = QUEUE_INITIAL_CAPACITY - 1;
+    q->head = 0;
+    q->tail = 0;
+    return q;
+}
+
+/*
+ * freeQueue: Releases the array and the queue itself.
+ */
+static inline void freeQueue(Queue* q) {
+    free(q->items);
+    free(q);
+}
+
+/*
+ * isEmpty: Checks if the queue is empty.
+ * Returns 1 (true) if the queue is empty, 0 (false) otherwise.
+ */
+static inline int isEmpty(Queue* q) {
+    return q->head == q->tail;
+}
+
+/*
+ * isFull: Checks if every slot of the array is in use.
+ * Returns 1 (true) if the queue is full, 0 (false) otherwise. A full queue still accepts
+ * elements: the next enqueue doubles its capacity.
+ */
+static inline int isFull(Queue* q) {
+    return q->tail - q->head == q->capacity;
+}
+
+/*
+ * size: Returns the number of elements currently in the queue.
+ * Explanation: Every element between the head and the tail position is in the queue.
+ */
+static inline int size(Queue* q) {
+    return (int)(q->tail - q->head);
+}
+
+/*
+ * copyOut: Copies count elements starting at position from into values, in queue order.
+ * Explanation: The elements occupy at most two contiguous spans of the array: from the slot of
+ * from up to the end of the array, and from the start of the array onwards.
+ */
+static inline void copyOut(Queue* q, unsigned int from, int* values, unsigned int count) {
+    unsigned int start = from & q->mask;
+    unsigned int first = q->capacity - start < count ? q->capacity - start : count;
+    memcpy(values, q->items + start, first * sizeof(int));
+    memcpy(values + first, q->items, (count - first) * sizeof(int));
+}
+
+/*
+ * copyIn: Copies count values into the slots starting at position to, the reverse of copyOut.
+ */
+static inline void copyIn(Queue* q, unsigned int to, const int* values, unsigned int count) {
+    unsigned int start = to & q->mask;
+    unsigned int first = q->capacity - start < count ? q->capacity - start : count;
+    memcpy(q->items + start, values, first * sizeof(int));
+    memcpy(q->items, values + first, (count - first) * sizeof(int));
+}
+
+/*
+ * reserve: Makes room for at least capacity elements, doubling the current capacity until it fits.
+ * Explanation: The elements are copied to the start of the new array in queue order, which
+ * unwraps the ring, and the positions are renumbered to start at 0.
+ */
+static void reserve(Queue* q, unsigned int capacity) {
+    if (capacity <= q->capacity) {
+        return;
+    }
+    unsigned int newCapacity = q->capacity;
+    while (newCapacity < capacity) {
+        if (newCapacity > UINT_MAX / 4) {
+            printf("Queue is too large.\n");
+            exit(1);
+        }
+        newCapacity *= 2;
+    }
+    int* items = (int*)malloc((size_t)newCapacity * sizeof(int));
+    if (items == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    unsigned int count = q->tail - q->head;
+    copyOut(q, q->head, items, count);
+    free(q->items);
+    q->items = items;
+    q->capacity = newCapacity;
+    q->mask = newCapacity - 1;
+    q->head = 0;
+    q->tail = count;
+}
+
+/*
+ * enqueue: Adds a new element to the rear of the queue.
+ * Explanation: This function stores the given value in the slot of the tail position and advances
+ * the tail. If every slot is in use, the queue first doubles its capacity.
+ */
+static inline void enqueue(Queue* q, int value) {
+    if (isFull(q)) {
+        reserve(q, q->capacity + 1);
+    }
+    q->items[q->tail & q->mask] = value;
+    q->tail++;
+}
+
+/*
+ * dequeue: Removes and returns the front element of the queue.
+ * If the queue is empty, it prints an error message and returns INT_MIN.
+ * Explanation: This function returns the element in the slot of the head position and advances
+ * the head, which frees the slot for a later enqueue.
+ */
+static inline int dequeue(Queue* q) {
+    if (isEmpty(q)) {
+        printf("Queue is empty. Cannot dequeue.\n");
+        return INT_MIN;
+    }
+    int value = q->items[q->head & q->mask];
+    q->head++;
+    return value;
+}
+
+/*
+ * enqueueMany: Adds count values to the rear of the queue, values[0] first.
+ * Explanation: The queue grows once if needed, then the values are copied with at most two memcpys.
+ */
+static inline void enqueueMany(Queue* q, const int* values, int count) {
+    if (count <= 0) {
+        return;
+    }
+    reserve(q, q->tail - q->head + (unsigned int)count);
+    copyIn(q, q->tail, values, (unsigned int)count);
+    q->tail += (unsigned int)count;
+}
+
+/*
+ * dequeueMany: Removes up to count elements from the front of the queue into values.
+ * Returns the number of elements removed, which is smaller than count if the queue runs empty.
+ */
+static inline int dequeueMany(Queue* q, int* values, int count) {
+    unsigned int available = q->tail - q->head;
+    if (count <= 0) {
+        return 0;
+    }
+    if ((unsigned int)count > available) {
+        count = (int)available;
+    }
+    copyOut(q, q->head, values, (unsigned int)count);
+    q->head += (unsigned int)count;
+    return count;
+}
+
+/*
+ * frontElement: Returns the element at the front of the queue without removing it.
+ * If the queue is empty, it prints an error message and returns INT_MIN.
+ * Explanation: This function retrieves the front element without dequeuing it.
+ */
+static inline int frontElement(Queue* q) {
+    if (isEmpty(q)) {
+        printf("Queue is empty. No front element.\n");
+        return INT_MIN;
+    }
+    return q->items[q->head & q->mask];
+}
+
+/*
+ * displayQueue: Prints all the elements in the queue from front to rear.
+ * Explanation: This function walks the positions from head to tail and prints the element in each slot.
+ */
+static inline void displayQueue(Queue* q) {
+    if (isEmpty(q)) {
+        printf("Queue is empty.\n");
+        return;
+    }
+    for (unsigned int i = q->head; i != q->tail; i++) {
+        printf("%d ", q->items[i & q->mask]);
+    }
+    printf("\n");
+}
+
+#endif // RING_QUEUE_H